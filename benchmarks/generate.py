@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+"""
+Generates large Oreo programs for benchmarking the compiler phases.
+
+Usage: generate.py <kind> <size> > program.oreo
+
+Kinds:
+    symbols - many declarations in nested scopes, each statement referencing
+              several identifiers (stresses symbol table lookups)
+    nested  - deeply nested blocks referring to globals and procedures
+              (stresses lookups through many enclosing scopes)
+    expressions - many assignments of bracketed integer and boolean
+              expressions over a few variables (stresses checking of
+              operators in the type checker)
+    chains  - assignments of long unbracketed operator chains such as
+              a + b - c + ... (stresses right-nested expression trees)
+    procedures - many procedures with typed parameters, each calling the
+              previous one in long expressions (stresses traversals that
+              both resolve and type check every statement)
+    common  - one procedure repeating the same few subexpressions of its
+              parameters in `size` statements under nested conditions
+              (stresses value numbering across blocks)
+    loops   - one procedure with `size` loops in sequence, each assigning
+              a few locals under a condition (stresses SSA construction
+              over a long routine with many join points)
+    invariant - one procedure with `size` pairs of nested loops, each
+              summing expressions of its parameters and the outer index
+              (stresses loop invariant code motion)
+    induction - one procedure with `size` counting loops, each summing
+              multiples of two counters stepping together (stresses
+              strength reduction; compare multiplications executed with --run)
+    pressure - one procedure with `size` locals computed from its parameters
+              in a loop, all live until they are summed at the end of each
+              iteration (stresses register allocation and spilling)
+"""
+import random
+import sys
+
+
+def symbols(size):
+    """Declares `size` globals, then nests blocks that keep referring to them"""
+    rng = random.Random(size)
+    lines = ["{- generated: symbols %d -}" % size, "program Bench", "begin"]
+
+    for i in range(size):
+        lines.append("    var int v%d := %d;" % (i, i))
+
+    depth = 8
+    for d in range(depth):
+        indent = "    " * (d + 1)
+        lines.append(indent + "if (v%d < v%d) then" % (d, d + 1))
+        lines.append(indent + "begin")
+        lines.append(indent + "    var int w%d := v%d;" % (d, d))
+
+    indent = "    " * (depth + 1)
+    for i in range(size):
+        a, b, c = (rng.randrange(size) for _ in range(3))
+        lines.append(indent + "v%d := v%d + v%d * w%d;" % (a, b, c, i % depth))
+
+    for d in reversed(range(depth)):
+        indent = "    " * (d + 1)
+        lines.append(indent + "end;")
+
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def nested(size):
+    """Nests `size` while loops, each referring to globals declared at the top"""
+    lines = ["{- generated: nested %d -}" % size, "program Bench", "begin"]
+
+    for i in range(16):
+        lines.append("    var int g%d := %d;" % (i, i))
+    lines.append("    procedure int f(var int n)")
+    lines.append("    begin")
+    lines.append("        return n + 1;")
+    lines.append("    end")
+
+    for d in range(size):
+        indent = "    " * (d + 1)
+        lines.append(indent + "while (g%d < %d)" % (d % 16, d))
+        lines.append(indent + "begin")
+        lines.append(indent + "    var int l%d := f(g%d) + g%d * g%d;" % (d, d % 16, (d + 5) % 16, (d + 9) % 16))
+
+    indent = "    " * (size + 1)
+    for i in range(size * 4):
+        lines.append(indent + "g%d := l%d + g%d - f(g%d);" % (i % 16, i % size, (i + 3) % 16, (i + 7) % 16))
+
+    for d in reversed(range(size)):
+        indent = "    " * (d + 1)
+        lines.append(indent + "end;")
+
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def procedures(size):
+    """Declares `size` procedures, each calling its predecessor, then calls the last"""
+    lines = ["{- generated: procedures %d -}" % size, "program Bench", "begin"]
+
+    lines.append("    var int total := 0;")
+    lines.append("    procedure int p0(var int n, var bool b)")
+    lines.append("    begin")
+    lines.append("        return n;")
+    lines.append("    end")
+
+    for i in range(1, size):
+        lines.append("    procedure int p%d(var int n, var bool b)" % i)
+        lines.append("    begin")
+        lines.append("        var int m := n * 2 + total - 1;")
+        lines.append("        if (b and m < n) then")
+        lines.append("        begin")
+        lines.append("            m := p%d(m + n, not b) + p%d(n, b);" % (i - 1, i - 1))
+        lines.append("        end;")
+        lines.append("        return m + n * (total + 3);")
+        lines.append("    end")
+
+    lines.append("    total := p%d(1, true);" % (size - 1))
+    lines.append("    println(total);")
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def loops(size):
+    """Declares one procedure running `size` loops in sequence over a few locals, then calls it"""
+    lines = ["{- generated: loops %d -}" % size, "program Bench", "begin"]
+
+    lines.append("    procedure int run(var int n)")
+    lines.append("    begin")
+    for i in range(4):
+        lines.append("        var int a%d := %d;" % (i, i))
+    lines.append("        var int i := 0;")
+
+    for l in range(size):
+        lines.append("        i := 0;")
+        lines.append("        while (i < n)")
+        lines.append("        begin")
+        lines.append("            if (a%d < a%d) then" % (l % 4, (l + 1) % 4))
+        lines.append("            begin")
+        lines.append("                a%d := a%d + i;" % (l % 4, (l + 2) % 4))
+        lines.append("            end")
+        lines.append("            else")
+        lines.append("            begin")
+        lines.append("                a%d := a%d - 1;" % ((l + 1) % 4, (l + 3) % 4))
+        lines.append("            end;")
+        lines.append("            i := i + 1;")
+        lines.append("        end;")
+
+    lines.append("        return a0 + a1 + a2 + a3;")
+    lines.append("    end")
+    lines.append("    println(run(10));")
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def invariant(size):
+    """Declares one procedure running `size` nested loops summing mostly invariant expressions, then calls it"""
+    rng = random.Random(size)
+    lines = ["{- generated: invariant %d -}" % size, "program Bench", "begin"]
+    terms = ["x * y", "y - x", "x * x + y", "i * x", "i + y * 2"]
+
+    lines.append("    procedure int run(var int x, var int y, var int n)")
+    lines.append("    begin")
+    lines.append("        var int total := 0;")
+    lines.append("        var int i := 0;")
+    lines.append("        var int j := 0;")
+
+    for l in range(size):
+        lines.append("        i := 0;")
+        lines.append("        while (i < n)")
+        lines.append("        begin")
+        lines.append("            j := 0;")
+        lines.append("            while (j < n)")
+        lines.append("            begin")
+        lines.append("                total := total + (%s) - (%s);" % (rng.choice(terms), rng.choice(terms)))
+        lines.append("                j := j + 1;")
+        lines.append("            end;")
+        lines.append("            i := i + 1;")
+        lines.append("        end;")
+
+    lines.append("        return total;")
+    lines.append("    end")
+    lines.append("    println(run(2, 3, 10));")
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def induction(size):
+    """Declares one procedure running `size` counting loops summing multiples of their counters, then calls it"""
+    rng = random.Random(size)
+    lines = ["{- generated: induction %d -}" % size, "program Bench", "begin"]
+    terms = ["i * 4", "j * 3", "i * 4 + j", "5 * i - x", "j * x"]
+
+    lines.append("    procedure int run(var int x, var int n)")
+    lines.append("    begin")
+    lines.append("        var int total := 0;")
+    lines.append("        var int i := 0;")
+    lines.append("        var int j := 0;")
+
+    for l in range(size):
+        lines.append("        i := 0;")
+        lines.append("        j := %d;" % (l % 2))
+        lines.append("        while (i < 100)")
+        lines.append("        begin")
+        lines.append("            total := total + (%s) - (%s);" % (rng.choice(terms), rng.choice(terms)))
+        lines.append("            i := i + 1;")
+        lines.append("            j := j + 1;")
+        lines.append("        end;")
+
+    lines.append("        return total;")
+    lines.append("    end")
+    lines.append("    println(run(7, 10));")
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def pressure(size):
+    """Declares one procedure keeping `size` locals live at once in a loop, then calls it twice"""
+    rng = random.Random(size)
+    lines = ["{- generated: pressure %d -}" % size, "program Bench", "begin"]
+    terms = ["x * %d", "y + %d", "x - y * %d", "i + %d", "(x + i) * %d"]
+
+    lines.append("    procedure int run(var int x, var int y)")
+    lines.append("    begin")
+    lines.append("        var int total := 0;")
+    lines.append("        var int i := 0;")
+    for v in range(size):
+        lines.append("        var int v%d := 0;" % v)
+
+    lines.append("        while (i < 10)")
+    lines.append("        begin")
+    for v in range(size):
+        lines.append("            v%d := %s;" % (v, rng.choice(terms) % (v + 1)))
+    for v in range(size):
+        lines.append("            total := total + v%d;" % v)
+    lines.append("            i := i + 1;")
+    lines.append("        end;")
+
+    lines.append("        return total;")
+    lines.append("    end")
+    # Called twice, so that it is not inlined and its parameters stay unknown
+    lines.append("    println(run(3, 5));")
+    lines.append("    println(run(4, 2));")
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def common(size):
+    """Declares one procedure recomputing subexpressions of its parameters in `size` statements, then calls it"""
+    rng = random.Random(size)
+    lines = ["{- generated: common %d -}" % size, "program Bench", "begin"]
+    terms = ["x * y", "y - z", "x + z", "(x * y) / (y - z)", "z * z + x"]
+
+    lines.append("    procedure int run(var int x, var int y, var int z)")
+    lines.append("    begin")
+    lines.append("        var int total := 0;")
+
+    for i in range(size):
+        lines.append("        if (%s < %s) then" % (rng.choice(terms), rng.choice(terms)))
+        lines.append("        begin")
+        lines.append("            total := total + %s;" % rng.choice(terms))
+        lines.append("        end;")
+        lines.append("        total := total - (%s);" % rng.choice(terms))
+
+    lines.append("        return total;")
+    lines.append("    end")
+    lines.append("    println(run(1, 2, 3));")
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def expressions(size):
+    """Assigns `size` expressions, alternating between integer and boolean results"""
+    rng = random.Random(size)
+    lines = ["{- generated: expressions %d -}" % size, "program Bench", "begin"]
+
+    for i in range(8):
+        lines.append("    var int i%d := %d;" % (i, i + 1))
+        lines.append("    var bool b%d := true;" % i)
+
+    def term():
+        # Short operator chains in brackets
+        v = ["i%d" % rng.randrange(8) for _ in range(4)]
+        return "(%s + %s * %s - %s)" % tuple(v)
+
+    for i in range(size):
+        if i % 2 == 0:
+            lines.append("    i%d := i%d * %s - %s * %s;" % (i % 8, rng.randrange(8), term(), term(), term()))
+        else:
+            lines.append("    b%d := i%d * %s < %s and not (b%d or i%d == %s);"
+                         % (i % 8, rng.randrange(8), term(), term(), rng.randrange(8), rng.randrange(8), term()))
+
+    lines.append("end")
+    return "\n".join(lines)
+
+
+def chains(size):
+    """Assigns 16 chains of `size` operators each, alternating between arithmetic and comparisons"""
+    rng = random.Random(size)
+    lines = ["{- generated: chains %d -}" % size, "program Bench", "begin"]
+
+    for i in range(8):
+        lines.append("    var int i%d := %d;" % (i, i + 1))
+        lines.append("    var bool b%d := true;" % i)
+
+    for i in range(16):
+        terms = ["i%d" % rng.randrange(8) for _ in range(size + 1)]
+        chain = terms[0]
+        for t in terms[1:]:
+            chain += " %s %s" % (rng.choice("+-*/"), t)
+
+        if i % 2 == 0:
+            lines.append("    i%d := %s;" % (i % 8, chain))
+        else:
+            lines.append("    b%d := %s < i%d and b%d;" % (i % 8, chain, rng.randrange(8), rng.randrange(8)))
+
+    lines.append("end")
+    return "\n".join(lines)
+
+
+KINDS = {
+    "symbols": symbols,
+    "nested": nested,
+    "expressions": expressions,
+    "chains": chains,
+    "procedures": procedures,
+    "loops": loops,
+    "common": common,
+    "invariant": invariant,
+    "induction": induction,
+    "pressure": pressure,
+}
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3 or sys.argv[1] not in KINDS:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+
+    # Oreo programs must not end with a trailing newline
+    sys.stdout.write(KINDS[sys.argv[1]](int(sys.argv[2])))
@@ -1,46 +1,307 @@
 #include <iostream>
 #include <map>
 #include <regex>
+#include <chrono>
+#include <thread>
+#include <algorithm>
 #include "parser/Lexer.h"
 #include "parser/Parser.h"
 #include "semantic/Semantic.h"
 #include "type_checking/TypeChecker.h"
 #include "tac_generation/TAC_Generator.h"
+#include "tac_generation/Interpreter.h"
+#include "optimisation/ControlFlowGraph.h"
+#include "optimisation/SSA.h"
+#include "optimisation/PassManager.h"
+#include "optimisation/RegisterAllocation.h"
+#include "optimisation/OptimisationException.h"
 
 using std::cout;
 using std::endl;
 
+//Clock used to time each phase of compilation
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Prints the time taken by a phase of compilation to stderr, keeping stdout unchanged
+ * @param phase - name of phase
+ * @param milliseconds - time taken
+ */
+static void reportDuration(const std::string& phase, double milliseconds) {
+    std::cerr << phase << ": " << milliseconds << " ms" << std::endl;
+}
+
+/**
+ * Prints the time taken by a phase of compilation to stderr, from the time it started
+ * @param phase - name of phase
+ * @param start - time at which phase started
+ */
+static void reportTime(const std::string& phase, Clock::time_point start) {
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    reportDuration(phase, elapsed.count());
+}
+
+/**
+ * Runs a program of three address code, printing its output followed by the number of instructions executed
+ * (and of multiplications, which strength reduction replaces), exiting with code 6 if it fails at runtime
+ * @param program - to run
+ * @param timePhases - whether to report the time taken
+ */
+static void runProgram(const Program& program, bool timePhases) {
+    cout << "Program Output:" << endl;
+    cout << "------------------------------------------------------------------" << endl;
+
+    Clock::time_point start = Clock::now();
+    Interpreter interpreter(program);
+    try {
+        interpreter.run();
+    } catch (RuntimeException& e) {
+        cout << endl << e.what() << endl;
+        exit(6);
+    }
+    if (timePhases) reportTime("Interpretation", start);
+
+    cout << endl << "Executed " << interpreter.getExecutedCount() << " instructions, of which "
+         << interpreter.getCount(Opcode::MULTIPLY) << " multiplications, with at most "
+         << interpreter.getMaxDepth() << " calls active" << endl;
+}
+
+/**
+ * Allocates the temporaries and local variables of each routine of a program to a register file,
+ * printing where each is kept and how many were spilled to the stack
+ * @param program - to allocate
+ * @param registers - number of registers in register file
+ * @param timePhases - whether to report the time taken
+ */
+static void allocateRegisters(const Program& program, uint32_t registers, bool timePhases) {
+    Clock::time_point start = Clock::now();
+    std::vector<Routine> routines = Routine::split(program);
+    std::vector<bool> nonLocal = SSAForm::findNonLocalVariables(program, routines);
+    std::vector<RegisterAllocation> allocations;
+    allocations.reserve(routines.size());
+    for (const Routine& routine : routines) {
+        allocations.emplace_back(routine, ControlFlowGraph(routine), nonLocal, registers);
+    }
+    if (timePhases) reportTime("Register allocation", start);
+
+    cout << "Register Allocation:" << endl;
+    cout << "------------------------------------------------------------------" << endl;
+    uint32_t spilled = 0;
+    for (unsigned long i = 0; i < routines.size(); i++) {
+        allocations[i].print(program, routines[i]);
+        spilled += allocations[i].getSpilledCount();
+    }
+    cout << "Allocated " << registers << " registers, spilling " << spilled << " temporaries and variables" << endl;
+}
+
+/**
+ * Reads the number given to an option (e.g. --registers=8), exiting with code 1 if it is not a number
+ * @param arg - option with its value
+ * @param prefix - length of the option's name up to and including '='
+ * @return number given
+ */
+static uint32_t parseCount(const std::string& arg, size_t prefix) {
+    std::string value = arg.substr(prefix);
+    if (!std::regex_match(value, std::regex("[0-9]{1,9}"))) {
+        cout << "Expected a number of at most 9 digits in " << arg << endl;
+        exit(1);
+    }
+
+    return std::stoul(value);
+}
+
 int main(int argc, char* argv[]) {
+    std::string fileName;
+    //Whether to report the time taken by each phase
+    bool timePhases = false;
+    //How semantic analysis resolves identifiers
+    Resolution resolution = Resolution::SCOPE_TREE;
+    //Whether type checking is performed in the same traversal as semantic analysis
+    bool fused = false;
+    //Number of threads used to check the bodies of top-level procedures
+    unsigned int jobs = 1;
+    //Whether to print the control flow graph of each routine
+    bool printGraphs = false;
+    //Whether to print each routine in static single assignment form
+    bool printSSA = false;
+    //Whether to check the consistency of static single assignment form after constructing it
+    bool verifySSA = false;
+    //Optimisation level, choosing the pipeline of passes unless one is given
+    uint32_t level = 0;
+    //Names of optimisation passes to run in place of those of the level, if given
+    std::string passes;
+    bool customPasses = false;
+    //Whether to check the three address code after every optimisation pass
+    bool verifyPasses = false;
+    //Whether value numbering only reuses results within blocks in the pipeline of the level
+    bool localNumbering = false;
+    //Number of registers to allocate the temporaries and variables of each routine to (none if 0)
+    uint32_t registers = 0;
+    //Whether to run the three address code (after optimisation, if optimising)
+    bool run = false;
+
+    //Separate options from the file name
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--time") {
+            timePhases = true;
+        } else if (arg == "--scoped-hash") {
+            resolution = Resolution::SCOPED_HASH;
+        } else if (arg == "--fused") {
+            fused = true;
+        } else if (arg == "--cfg") {
+            printGraphs = true;
+        } else if (arg == "--ssa") {
+            printSSA = true;
+        } else if (arg == "--verify-ssa") {
+            verifySSA = true;
+        } else if (arg == "-O") {
+            level = 2;
+        } else if (std::regex_match(arg, std::regex("-O[0-2]"))) {
+            level = arg[2] - '0';
+        } else if (std::regex_match(arg, std::regex("-O[0-9]+"))) {
+            cout << "Unknown optimisation level " << arg << ", expected -O0, -O1 or -O2" << endl;
+            exit(1);
+        } else if (arg.rfind("--passes=", 0) == 0) {
+            passes = arg.substr(9);
+            customPasses = true;
+        } else if (arg == "--verify-passes") {
+            verifyPasses = true;
+        } else if (arg == "--lvn") {
+            localNumbering = true;
+        } else if (arg == "--run") {
+            run = true;
+        } else if (arg.rfind("--registers=", 0) == 0) {
+            registers = parseCount(arg, 12);
+        } else if (arg.rfind("--jobs=", 0) == 0) {
+            //Uses every hardware thread if given 0
+            jobs = parseCount(arg, 7);
+            if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+        } else {
+            fileName = arg;
+        }
+    }
+
+    if (!customPasses) passes = PassManager::getPreset(level, localNumbering);
+    //Whether to optimise the three address code
+    bool optimise = !passes.empty();
+
     //If file is provided as argument
-    if (argc > 1) {
-        //Store filename
-        std::string fileName = std::string(argv[1]);
+    if (!fileName.empty()) {
+        Clock::time_point start = Clock::now();
 
         //Perform lexical analysis on file
         //and print tokens
         Lexer lexer(fileName);
+        if (timePhases) reportTime("Lexical analysis", start);
         lexer.printTokens();
 
         //Perform syntactic analysis on file
         //and print abstract syntax tree
+        start = Clock::now();
         Parser parser(lexer.getTokenList());
+        if (timePhases) reportTime("Syntactic analysis", start);
         parser.printTree();
 
-        //Perform semantic analysis on parse tree
-        Semantic semantic;
-        semantic.analyse(parser.getParseTree());
+        //Perform semantic analysis on parse tree,
+        //type checking each statement in the same traversal if fused
+        start = Clock::now();
+        std::shared_ptr<TypeChecker> typeChecker = std::make_shared<TypeChecker>(jobs);
+        Semantic semantic(resolution, jobs);
+        semantic.analyse(parser.getParseTree(), fused ? typeChecker : nullptr);
+        if (timePhases) reportTime(fused ? "Semantic analysis and type checking" : "Semantic analysis", start);
         //Print scopes and symbol tables
         semantic.printTree(semantic.getGlobalScope());
 
-        //Perform type checking on parse tree
-        TypeChecker typeChecker;
-        typeChecker.checkTypes(parser.getParseTree(), semantic.getGlobalScope());
+        //Perform type checking on parse tree, or report the result of the fused pass
+        start = Clock::now();
+        if (fused) {
+            typeChecker->report();
+        } else {
+            typeChecker->checkTypes(parser.getParseTree(), semantic.getGlobalScope());
+            if (timePhases) reportTime("Type checking", start);
+        }
 
         //Perform three address code generation
+        start = Clock::now();
         TAC_Generator tacGenerator;
         tacGenerator.generate(parser.getParseTree());
+        if (timePhases) reportTime("Three address code generation", start);
         tacGenerator.printInstructions();
 
+        //Build and print the control flow graph of each routine
+        if (printGraphs) {
+            start = Clock::now();
+            std::vector<Routine> routines = Routine::split(tacGenerator.getProgram());
+            std::vector<ControlFlowGraph> graphs;
+            for (const Routine& routine : routines) {
+                graphs.emplace_back(routine);
+            }
+            if (timePhases) reportTime("Control flow graph construction", start);
+
+            cout << "Control Flow Graphs:" << endl;
+            cout << "------------------------------------------------------------------" << endl;
+            for (unsigned long i = 0; i < routines.size(); i++) {
+                graphs[i].print(tacGenerator.getProgram(), routines[i]);
+            }
+        }
+
+        //Convert each routine into static single assignment form, optimise it, and convert it back
+        if (printSSA || verifySSA || optimise) {
+            Program program = tacGenerator.getProgram();
+            PassManager manager(program);
+            manager.setVerifyEach(verifyPasses);
+            try {
+                manager.setPipeline(passes);
+            } catch (OptimisationException& e) {
+                cout << e.what() << endl;
+                exit(1);
+            }
+
+            try {
+                manager.runBeforeDestruction();
+                if (verifySSA) {
+                    for (const SSAForm& form : manager.getForms()) {
+                        form.verify();
+                    }
+                }
+            } catch (OptimisationException& e) {
+                cout << e.what() << endl;
+                exit(5);
+            }
+
+            if (printSSA) {
+                cout << "Static Single Assignment Form:" << endl;
+                cout << "------------------------------------------------------------------" << endl;
+                for (const SSAForm& form : manager.getForms()) {
+                    form.print();
+                }
+            }
+
+            try {
+                manager.runAfterDestruction();
+            } catch (OptimisationException& e) {
+                cout << e.what() << endl;
+                exit(5);
+            }
+            if (timePhases) {
+                for (const std::pair<std::string, double>& time : manager.getTimes()) {
+                    reportDuration(time.first, time.second);
+                }
+            }
+
+            if (optimise) {
+                program.print("Optimised Three Address Code:");
+                manager.printStatistics();
+                if (registers > 0) allocateRegisters(program, registers, timePhases);
+                if (run) runProgram(program, timePhases);
+            }
+        }
+
+        if (registers > 0 && !optimise) allocateRegisters(tacGenerator.getProgram(), registers, timePhases);
+        if (run && !optimise) runProgram(tacGenerator.getProgram(), timePhases);
+
         //TODO list:
         //TODO - report on three address code generation
     }
@@ -0,0 +1,208 @@
+#include "Coalescing.h"
+
+/**
+ * Coalesces the temporaries of a routine: merges the two sides of each copy whose lifetimes do not overlap
+ * (never merging two variables) and removes the copy, then colours the temporaries left so that those
+ * whose lifetimes overlap have different names
+ * @param routine - to coalesce temporaries of
+ * @param nonLocal - whether each variable of the program is used by a routine other than the one declaring it
+ */
+Coalescing::Coalescing(Routine &routine, const std::vector<bool> &nonLocal)
+        : routine(routine), nonLocal(nonLocal), removedCount(0), tempsBefore(0), tempsAfter(0) {
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    ControlFlowGraph graph(routine);
+    std::vector<bool> removed(instructions.size(), false);
+    Liveness liveness(routine, graph, nonLocal, removed);
+
+    neighbours.assign(liveness.getCount(), std::vector<uint32_t>());
+    parents.resize(liveness.getCount());
+    for (uint32_t index = 0; index < liveness.getCount(); index++) {
+        parents[index] = index;
+        if (liveness.getStorage(index).getKind() == OperandKind::TEMP) tempsBefore++;
+    }
+    buildInterference(graph, liveness);
+
+    auto isTemp = [&liveness](uint32_t index) {
+        return liveness.getStorage(index).getKind() == OperandKind::TEMP;
+    };
+
+    //Merges the two sides of each copy, keeping the variable if either is one
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        const Instruction& instruction = instructions[i];
+        if (instruction.getOp() != Opcode::ASSIGN) continue;
+
+        uint32_t destination = liveness.getIndex(instruction.getResult());
+        uint32_t source = liveness.getIndex(instruction.getArg1().empty() ? instruction.getArg2() : instruction.getArg1());
+        if (destination == UINT32_MAX || source == UINT32_MAX) continue;
+
+        uint32_t kept = find(destination);
+        uint32_t merged = find(source);
+        if (kept != merged) {
+            if ((!isTemp(kept) && !isTemp(merged)) || interferes(kept, merged)) continue;
+            if (!isTemp(merged)) std::swap(kept, merged);
+
+            parents[merged] = kept;
+            for (uint32_t neighbour : neighbours[merged]) {
+                if (find(neighbour) != kept) interfere(kept, find(neighbour));
+            }
+        }
+
+        removed[i] = true;
+        removedCount++;
+    }
+
+    //Colours each temporary left with the first name none of the temporaries it overlaps with has
+    std::vector<Operand> names;
+    for (uint32_t index = 0; index < liveness.getCount(); index++) {
+        if (isTemp(index)) names.push_back(liveness.getStorage(index));
+    }
+
+    std::vector<uint32_t> colours(liveness.getCount(), UINT32_MAX);
+    std::vector<uint32_t> taken(names.size() + 1, UINT32_MAX);
+    for (uint32_t index = 0; index < liveness.getCount(); index++) {
+        if (find(index) != index || !isTemp(index)) continue;
+
+        for (uint32_t neighbour : neighbours[index]) {
+            uint32_t colour = colours[find(neighbour)];
+            if (colour != UINT32_MAX) taken[colour] = index;
+        }
+
+        uint32_t colour = 0;
+        while (taken[colour] == index) colour++;
+        colours[index] = colour;
+        tempsAfter = std::max(tempsAfter, colour + 1);
+    }
+
+    auto rename = [&](const Operand& operand) {
+        uint32_t index = liveness.getIndex(operand);
+        if (index == UINT32_MAX) return operand;
+
+        uint32_t root = find(index);
+        return isTemp(root) ? names[colours[root]] : liveness.getStorage(root);
+    };
+
+    for (Instruction& instruction : instructions) {
+        instruction.setArg1(rename(instruction.getArg1()));
+        instruction.setArg2(rename(instruction.getArg2()));
+        instruction.setResult(rename(instruction.getResult()));
+    }
+
+    routine.erase(removed);
+}
+
+/**
+ * Records that the lifetimes of two temporaries or variables overlap
+ * @param first - index of temporary or variable
+ * @param second - index of temporary or variable
+ */
+void Coalescing::interfere(uint32_t first, uint32_t second) {
+    uint64_t key = (uint64_t(std::min(first, second)) << 32) | std::max(first, second);
+
+    if (interfering.insert(key).second) {
+        neighbours[first].push_back(second);
+        neighbours[second].push_back(first);
+    }
+}
+
+/**
+ * Returns whether the lifetimes of two temporaries or variables overlap
+ * @param first - index of temporary or variable
+ * @param second - index of temporary or variable
+ * @return whether they interfere
+ */
+bool Coalescing::interferes(uint32_t first, uint32_t second) const {
+    return interfering.count((uint64_t(std::min(first, second)) << 32) | std::max(first, second)) != 0;
+}
+
+/**
+ * Finds the temporary or variable which another was merged into, shortening the path to it
+ * @param index - of temporary or variable
+ * @return index of temporary or variable it was merged into
+ */
+uint32_t Coalescing::find(uint32_t index) {
+    while (parents[index] != index) {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+
+    return index;
+}
+
+/**
+ * Finds which temporaries and variables have overlapping lifetimes, walking each block backwards: an assignment
+ * overlaps everything live after it, except the source of a copy (as both then hold the same value).
+ * Those live on entry to the routine (parameters, and temporaries only assigned by calls) overlap each other
+ * @param graph - of routine
+ * @param liveness - of routine
+ */
+void Coalescing::buildInterference(const ControlFlowGraph &graph, const Liveness &liveness) {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    std::vector<uint64_t> live(liveness.getWords());
+
+    //Records that a temporary or variable overlaps each one live, other than an exception
+    auto overlap = [&](uint32_t index, uint32_t except) {
+        for (uint32_t word = 0; word < live.size(); word++) {
+            for (uint64_t bits = live[word]; bits != 0; bits &= bits - 1) {
+                uint32_t other = word * 64 + __builtin_ctzll(bits);
+                bool variables = liveness.getStorage(index).getKind() == OperandKind::VARIABLE
+                                 && liveness.getStorage(other).getKind() == OperandKind::VARIABLE;
+                if (other != index && other != except && !variables) interfere(index, other);
+            }
+        }
+    };
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        std::copy(liveness.getLiveOut(block), liveness.getLiveOut(block) + liveness.getWords(), live.begin());
+
+        for (uint32_t i = graph.getEnd(block); i-- > graph.getBegin(block);) {
+            const Instruction& instruction = instructions[i];
+            uint32_t index = liveness.getIndex(instruction.getResult());
+
+            if (index != UINT32_MAX) {
+                uint32_t source = UINT32_MAX;
+                if (instruction.getOp() == Opcode::ASSIGN) {
+                    source = liveness.getIndex(instruction.getArg1().empty() ? instruction.getArg2() : instruction.getArg1());
+                }
+                overlap(index, source);
+                Liveness::erase(live.data(), index);
+            }
+
+            for (const Operand* use : {&instruction.getArg1(), &instruction.getArg2()}) {
+                uint32_t used = liveness.getIndex(*use);
+                if (used != UINT32_MAX) Liveness::insert(live.data(), used);
+            }
+        }
+
+        if (block == graph.getEntry()) {
+            for (uint32_t word = 0; word < live.size(); word++) {
+                for (uint64_t bits = live[word]; bits != 0; bits &= bits - 1) {
+                    overlap(word * 64 + __builtin_ctzll(bits), UINT32_MAX);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Getter for number of copies removed
+ * @return number of copies removed
+ */
+uint32_t Coalescing::getRemovedCount() const {
+    return removedCount;
+}
+
+/**
+ * Getter for number of distinct temporaries before coalescing
+ * @return number of temporaries
+ */
+uint32_t Coalescing::getTempsBefore() const {
+    return tempsBefore;
+}
+
+/**
+ * Getter for number of distinct temporaries after coalescing
+ * @return number of temporaries
+ */
+uint32_t Coalescing::getTempsAfter() const {
+    return tempsAfter;
+}
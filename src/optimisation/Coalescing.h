@@ -0,0 +1,60 @@
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+#include "Liveness.h"
+
+/**
+ * Coalesces the temporaries of a routine after it leaves static single assignment form. A copy between a
+ * temporary and another temporary or local variable is removed by renaming one to the other, where their
+ * lifetimes do not overlap. The temporaries left are then renamed so that temporaries whose lifetimes do not
+ * overlap share a name, taken from those the routine already used
+ */
+class Coalescing {
+private:
+    //Routine to coalesce temporaries of
+    Routine& routine;
+
+    //Whether each variable of the program is used by a routine other than the one declaring it
+    const std::vector<bool>& nonLocal;
+
+    //Temporaries and local variables whose lifetimes overlap, by pair of indices (smaller first)
+    std::unordered_set<uint64_t> interfering;
+
+    //Temporaries and local variables each one's lifetime overlaps, by index
+    std::vector<std::vector<uint32_t>> neighbours;
+
+    //Index each temporary or variable was merged into (itself if not merged)
+    std::vector<uint32_t> parents;
+
+    //Number of copies removed
+    uint32_t removedCount;
+
+    //Number of temporaries before and after coalescing
+    uint32_t tempsBefore;
+    uint32_t tempsAfter;
+
+    //Records that the lifetimes of two temporaries or variables overlap
+    void interfere(uint32_t first, uint32_t second);
+
+    //Returns whether the lifetimes of two temporaries or variables overlap
+    bool interferes(uint32_t first, uint32_t second) const;
+
+    //Finds the temporary or variable which another was merged into
+    uint32_t find(uint32_t index);
+
+    //Finds which temporaries and variables have overlapping lifetimes
+    void buildInterference(const ControlFlowGraph& graph, const Liveness& liveness);
+public:
+    //Coalesces the temporaries of a routine
+    Coalescing(Routine& routine, const std::vector<bool>& nonLocal);
+
+    //Getter for number of copies removed
+    uint32_t getRemovedCount() const;
+
+    //Getter for number of distinct temporaries before coalescing
+    uint32_t getTempsBefore() const;
+
+    //Getter for number of distinct temporaries after coalescing
+    uint32_t getTempsAfter() const;
+};
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <limits>
+#include "ConstantPropagation.h"
+
+/**
+ * Propagates constants through a routine in static single assignment form
+ * @param form - of routine, rewritten in place
+ */
+ConstantPropagation::ConstantPropagation(SSAForm &form) : form(form), removedCount(0), branchCount(0) {
+    propagate();
+    rewrite();
+}
+
+/**
+ * Gets the value of an operand: immediates are constant, while versions which are not renamed
+ * or are the value on entry to the routine (version 0) vary
+ * @param operand - to get value of
+ * @return value in lattice
+ */
+ConstantPropagation::Value ConstantPropagation::getValue(const Operand &operand) const {
+    if (operand.isImmediate()) return {State::CONSTANT, operand};
+    if (!form.isRenamed(operand) || operand.getVersion() == 0) return {State::VARYING, Operand()};
+
+    auto it = values.find(operand.getKey());
+    return (it == values.end()) ? Value {State::UNDEFINED, Operand()} : it->second;
+}
+
+/**
+ * Lowers the value of a version to its meet with another value, so that values only ever
+ * move from undefined to constant to varying
+ * @param version - assigned
+ * @param value - to meet with
+ * @return whether the value of version changed
+ */
+bool ConstantPropagation::lower(const Operand &version, const Value &value) {
+    Value current = getValue(version);
+    Value lowered = current;
+
+    if (current.state == State::UNDEFINED) {
+        lowered = value;
+    } else if (current.state == State::CONSTANT && value.state != State::UNDEFINED
+               && (value.state == State::VARYING || value.constant != current.constant)) {
+        lowered = {State::VARYING, Operand()};
+    }
+
+    if (lowered.state == current.state) return false;
+    values[version.getKey()] = lowered;
+    return true;
+}
+
+/**
+ * Finds the value assigned by an instruction from the values of its arguments
+ * @param instruction - assigning a renamed version
+ * @return value assigned
+ */
+ConstantPropagation::Value ConstantPropagation::evaluate(const Instruction &instruction) const {
+    Opcode op = instruction.getOp();
+
+    if (op == Opcode::ASSIGN) {
+        return getValue(instruction.getArg1().empty() ? instruction.getArg2() : instruction.getArg1());
+    }
+    if (!Opcodes::isOperation(op)) return {State::VARYING, Operand()};
+
+    //'not' has no first argument
+    Value first = (op == Opcode::NOT) ? Value {State::CONSTANT, Operand()} : getValue(instruction.getArg1());
+    Value second = getValue(instruction.getArg2());
+
+    //False and anything is false, and true or anything is true
+    for (const Value& value : {first, second}) {
+        if (value.state != State::CONSTANT) continue;
+        if (op == Opcode::AND && value.constant == Operand::boolean(false)) return value;
+        if (op == Opcode::OR && value.constant == Operand::boolean(true)) return value;
+    }
+
+    if (first.state == State::UNDEFINED || second.state == State::UNDEFINED) return {State::UNDEFINED, Operand()};
+    if (first.state == State::VARYING || second.state == State::VARYING) return {State::VARYING, Operand()};
+
+    Operand result = fold(op, first.constant, second.constant);
+    return result.empty() ? Value {State::VARYING, Operand()} : Value {State::CONSTANT, result};
+}
+
+/**
+ * Marks an edge out of a block as taken, and its successor as executable
+ * @param block - which the edge leaves
+ * @param successor - index of edge in block's successors
+ * @return whether the edge was not already taken
+ */
+bool ConstantPropagation::take(uint32_t block, uint32_t successor) {
+    if (taken[block][successor]) return false;
+
+    taken[block][successor] = true;
+    executable[form.getGraph().getSuccessors(block)[successor]] = true;
+    return true;
+}
+
+/**
+ * Returns whether the edge from one block to another can be taken
+ * @param block - which the edge leaves
+ * @param successor - block which the edge enters
+ * @return whether edge is taken
+ */
+bool ConstantPropagation::isTaken(uint32_t block, uint32_t successor) const {
+    const std::array<uint32_t, 2>& successors = form.getGraph().getSuccessors(block);
+    return (successors[0] == successor && taken[block][0]) || (successors[1] == successor && taken[block][1]);
+}
+
+/**
+ * Finds the value of each version, visiting the executable blocks in reverse postorder until no value
+ * changes and no more edges are taken. Phi functions only meet the values of edges which are taken
+ */
+void ConstantPropagation::propagate() {
+    const ControlFlowGraph& graph = form.getGraph();
+    const std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+
+    executable.assign(graph.getBlockCount(), false);
+    taken.assign(graph.getBlockCount(), {false, false});
+    executable[graph.getEntry()] = true;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (uint32_t block : graph.getReversePostorder()) {
+            if (!executable[block]) continue;
+
+            for (const SSAForm::Phi& phi : form.getPhis(block)) {
+                Value value {State::UNDEFINED, Operand()};
+                BlockRange predecessors = graph.getPredecessors(block);
+
+                for (uint32_t i = 0; i < phi.arguments.size(); i++) {
+                    if (!isTaken(predecessors.begin()[i], block)) continue;
+
+                    Value argument = getValue(phi.arguments[i]);
+                    if (value.state == State::UNDEFINED) {
+                        value = argument;
+                    } else if (argument.state == State::VARYING
+                               || (argument.state == State::CONSTANT && argument.constant != value.constant)) {
+                        value = {State::VARYING, Operand()};
+                    }
+                }
+                changed |= lower(phi.result, value);
+            }
+
+            for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+                if (!form.isRemoved(i) && form.isRenamed(instructions[i].getResult())) {
+                    changed |= lower(instructions[i].getResult(), evaluate(instructions[i]));
+                }
+            }
+
+            //Only takes the edge of a conditional branch which its condition selects, if known. A branch folded
+            //into a jump by an earlier run keeps both edges of the branch, so only its target (the second) is taken
+            const Instruction& last = instructions[graph.getEnd(block) - 1];
+            const std::array<uint32_t, 2>& successors = graph.getSuccessors(block);
+
+            if (last.getOp() == Opcode::GOTO && successors[1] != ControlFlowGraph::NO_BLOCK) {
+                changed |= take(block, 1);
+            } else if (last.getOp() == Opcode::IFZ && successors[1] != ControlFlowGraph::NO_BLOCK) {
+                Value condition = getValue(last.getArg1());
+
+                if (condition.state == State::CONSTANT) {
+                    changed |= take(block, condition.constant.getValue() ? 0 : 1);
+                } else if (condition.state == State::VARYING) {
+                    changed |= take(block, 0);
+                    changed |= take(block, 1);
+                }
+            } else if (successors[0] != ControlFlowGraph::NO_BLOCK) {
+                changed |= take(block, 0);
+            }
+        }
+    }
+}
+
+/**
+ * Replaces each use of a constant version with the constant and removes its assignment,
+ * then replaces branches on constants with a jump (if always taken) or removes them (if never taken)
+ */
+void ConstantPropagation::rewrite() {
+    const ControlFlowGraph& graph = form.getGraph();
+    std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+
+    //Gets the constant of a version if it has one
+    auto replace = [this](const Operand& operand) {
+        Value value = getValue(operand);
+        return (form.isRenamed(operand) && value.state == State::CONSTANT) ? value.constant : operand;
+    };
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        std::vector<SSAForm::Phi>& phis = form.getPhis(block);
+
+        for (SSAForm::Phi& phi : phis) {
+            for (Operand& argument : phi.arguments) {
+                argument = replace(argument);
+            }
+        }
+        phis.erase(std::remove_if(phis.begin(), phis.end(), [this](const SSAForm::Phi& phi) {
+            return getValue(phi.result).state == State::CONSTANT;
+        }), phis.end());
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            //Instructions removed by an earlier run (or another pass) are neither rewritten nor counted again
+            if (form.isRemoved(i)) continue;
+
+            Instruction& instruction = instructions[i];
+            instruction.setArg1(replace(instruction.getArg1()));
+            instruction.setArg2(replace(instruction.getArg2()));
+
+            //Every use of a constant was replaced, so its assignment is no longer needed
+            const Operand& result = instruction.getResult();
+            if (form.isRenamed(result) && getValue(result).state == State::CONSTANT) {
+                form.remove(i);
+                removedCount++;
+                continue;
+            }
+
+            if (instruction.getOp() != Opcode::IFZ || !instruction.getArg1().isImmediate() || !executable[block]) continue;
+            branchCount++;
+
+            if (instruction.getArg1().getValue()) {
+                //Condition is always true, so never branches
+                form.remove(i);
+                removedCount++;
+            } else {
+                //Condition is always false, so always branches
+                instruction.setOp(Opcode::GOTO);
+                instruction.setArg1(instruction.getResult());
+                instruction.setResult(Operand());
+            }
+        }
+    }
+}
+
+/**
+ * Getter for number of instructions removed
+ * @return number of assignments of constants and branches removed
+ */
+uint32_t ConstantPropagation::getRemovedCount() const {
+    return removedCount;
+}
+
+/**
+ * Getter for number of conditional branches folded
+ * @return number of branches replaced by a jump or removed
+ */
+uint32_t ConstantPropagation::getBranchCount() const {
+    return branchCount;
+}
+
+/**
+ * Applies an operation to immediate arguments as it would be at runtime. Division by zero and
+ * arithmetic overflowing an int are left to happen at runtime, so are not folded
+ * @param op - operation
+ * @param arg1 - first argument (empty for 'not')
+ * @param arg2 - second argument
+ * @return immediate result, or an empty operand if it cannot be folded
+ */
+Operand ConstantPropagation::fold(Opcode op, const Operand &arg1, const Operand &arg2) {
+    long op1 = arg1.getInt();
+    long op2 = arg2.getInt();
+    long result = 0;
+
+    switch (op) {
+        case Opcode::PLUS:
+            result = op1 + op2;
+            break;
+        case Opcode::MINUS:
+            result = op1 - op2;
+            break;
+        case Opcode::MULTIPLY:
+            result = op1 * op2;
+            break;
+        case Opcode::DIVIDE:
+            if (op2 == 0) return Operand();
+            result = op1 / op2;
+            break;
+        case Opcode::AND:
+            return Operand::boolean(op1 && op2);
+        case Opcode::OR:
+            return Operand::boolean(op1 || op2);
+        case Opcode::NOT:
+            return Operand::boolean(!op2);
+        case Opcode::LT:
+            return Operand::boolean(op1 < op2);
+        case Opcode::GT:
+            return Operand::boolean(op1 > op2);
+        case Opcode::LTE:
+            return Operand::boolean(op1 <= op2);
+        case Opcode::GTE:
+            return Operand::boolean(op1 >= op2);
+        case Opcode::EQ:
+            //Only ints and bools can be compared, and both arguments have the same type
+            return Operand::boolean(arg1 == arg2);
+        default:
+            return Operand();
+    }
+
+    //Arithmetic on ints cannot exceed their range (both arguments fit in an int, so this cannot overflow a long)
+    if (result > std::numeric_limits<int>::max() || result < std::numeric_limits<int>::min()) return Operand();
+
+    return Operand::integer(result);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+#include "SSA.h"
+
+/**
+ * Sparse conditional constant propagation over a routine in static single assignment form (Wegman and Zadeck).
+ * Finds the versions which hold the same constant on every path which can be executed, only following the
+ * edges of branches whose condition is not a known constant. Uses of those versions are replaced by the constant,
+ * their assignments are removed, and branches on constants become jumps or fall through
+ */
+class ConstantPropagation {
+private:
+    //Whether the value of a version is not yet known, a single constant, or varies at runtime
+    enum class State : uint8_t {
+        UNDEFINED,
+        CONSTANT,
+        VARYING
+    };
+
+    //Value of a version in the lattice
+    struct Value {
+        State state;
+        //Immediate value, if constant
+        Operand constant;
+    };
+
+    //Routine to propagate constants through
+    SSAForm& form;
+
+    //Value of each version assigned, by key (undefined if not present)
+    std::unordered_map<uint64_t, Value> values;
+
+    //Whether each block can be executed
+    std::vector<bool> executable;
+
+    //Whether each successor edge of each block can be taken
+    std::vector<std::array<bool, 2>> taken;
+
+    //Number of instructions removed
+    uint32_t removedCount;
+
+    //Number of conditional branches replaced by a jump or removed
+    uint32_t branchCount;
+
+    //Gets the value of an operand
+    Value getValue(const Operand& operand) const;
+
+    //Lowers the value of a version to its meet with another value
+    bool lower(const Operand& version, const Value& value);
+
+    //Finds the value assigned by an instruction from the values of its arguments
+    Value evaluate(const Instruction& instruction) const;
+
+    //Marks an edge out of a block as taken, and its successor as executable
+    bool take(uint32_t block, uint32_t successor);
+
+    //Returns whether the edge from one block to another can be taken
+    bool isTaken(uint32_t block, uint32_t successor) const;
+
+    //Finds the value of each version, iterating over the executable blocks until none change
+    void propagate();
+
+    //Replaces constant versions and folds branches on constants
+    void rewrite();
+public:
+    //Propagates constants through a routine in static single assignment form
+    explicit ConstantPropagation(SSAForm& form);
+
+    //Getter for number of instructions removed
+    uint32_t getRemovedCount() const;
+
+    //Getter for number of conditional branches folded
+    uint32_t getBranchCount() const;
+
+    //Applies an operation to immediate arguments, giving an empty operand if it cannot be folded
+    static Operand fold(Opcode op, const Operand& arg1, const Operand& arg2);
+};
@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include "ControlFlowGraph.h"
+
+/**
+ * Builds the control flow graph of a routine
+ * @param routine - to build graph of
+ */
+ControlFlowGraph::ControlFlowGraph(const Routine &routine) {
+    buildBlocks(routine);
+    buildOrder();
+    buildDominators();
+}
+
+/**
+ * Splits instructions into blocks and links each block to its successors and predecessors
+ * @param routine - to split
+ */
+void ControlFlowGraph::buildBlocks(const Routine &routine) {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    blocks.assign(instructions.size(), 0);
+
+    //A block begins at the first instruction, at each label, at the end of the routine,
+    //and after each instruction which transfers control
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        Opcode op = instructions[i].getOp();
+        bool leader = (i == 0 || instructions[i].hasLabel() || op == Opcode::END_FUNC || op == Opcode::END_PROG);
+
+        if (!leader) {
+            Opcode previous = instructions[i - 1].getOp();
+            leader = (previous == Opcode::IFZ || previous == Opcode::GOTO || previous == Opcode::RETURN
+                      || previous == Opcode::BEGIN_FUNC || previous == Opcode::BEGIN_PROG);
+        }
+
+        if (leader) starts.push_back(i);
+        blocks[i] = starts.size() - 1;
+    }
+    starts.push_back(instructions.size());
+
+    //Maps the label of each block to it
+    std::unordered_map<uint32_t, uint32_t> labelled;
+    for (uint32_t block = 0; block < getBlockCount(); block++) {
+        const Instruction& first = instructions[starts[block]];
+        if (first.hasLabel()) labelled[first.getLabel()] = block;
+    }
+
+    //Finds the block of a branch target
+    auto target = [&labelled](const Operand& label) {
+        auto it = labelled.find(label.getValue());
+        return (it == labelled.end()) ? NO_BLOCK : it->second;
+    };
+
+    successors.assign(getBlockCount(), {NO_BLOCK, NO_BLOCK});
+    for (uint32_t block = 0; block < getBlockCount(); block++) {
+        const Instruction& last = instructions[starts[block + 1] - 1];
+
+        switch (last.getOp()) {
+            case Opcode::IFZ:
+                successors[block][0] = block + 1;
+                //Only records the branch target if it is not also the block fallen through to
+                if (target(last.getResult()) != block + 1) successors[block][1] = target(last.getResult());
+                break;
+            case Opcode::GOTO:
+                successors[block][0] = target(last.getArg1());
+                break;
+            case Opcode::RETURN:
+                successors[block][0] = getExit();
+                break;
+            case Opcode::END_FUNC:
+            case Opcode::END_PROG:
+                break;
+            default:
+                successors[block][0] = block + 1;
+        }
+    }
+
+    //Counts the predecessors of each block, then places them contiguously
+    predecessorStarts.assign(getBlockCount() + 1, 0);
+    for (const std::array<uint32_t, 2>& edges : successors) {
+        for (uint32_t successor : edges) {
+            if (successor != NO_BLOCK) predecessorStarts[successor + 1]++;
+        }
+    }
+    for (uint32_t block = 0; block < getBlockCount(); block++) {
+        predecessorStarts[block + 1] += predecessorStarts[block];
+    }
+
+    predecessors.assign(predecessorStarts.back(), NO_BLOCK);
+    std::vector<uint32_t> next(predecessorStarts.begin(), predecessorStarts.end() - 1);
+    for (uint32_t block = 0; block < getBlockCount(); block++) {
+        for (uint32_t successor : successors[block]) {
+            if (successor != NO_BLOCK) predecessors[next[successor]++] = block;
+        }
+    }
+}
+
+/**
+ * Numbers the blocks reachable from the entry block in reverse postorder,
+ * using an explicit stack so that long routines cannot overflow the call stack
+ */
+void ControlFlowGraph::buildOrder() {
+    orderIndices.assign(getBlockCount(), NO_BLOCK);
+    std::vector<uint8_t> visited(getBlockCount(), 0);
+    //Blocks being visited, with the number of their successors visited so far
+    std::vector<std::pair<uint32_t, uint8_t>> stack;
+
+    stack.emplace_back(getEntry(), 0);
+    visited[getEntry()] = 1;
+
+    while (!stack.empty()) {
+        std::pair<uint32_t, uint8_t>& top = stack.back();
+
+        if (top.second < 2) {
+            uint32_t successor = successors[top.first][top.second++];
+            if (successor != NO_BLOCK && !visited[successor]) {
+                visited[successor] = 1;
+                stack.emplace_back(successor, 0);
+            }
+        } else {
+            //Records block once all of its successors have been visited
+            order.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        orderIndices[order[i]] = i;
+    }
+}
+
+/**
+ * Finds the immediate dominator of each reachable block by iterating over the blocks in reverse postorder
+ * until no dominator changes (Cooper, Harvey and Kennedy), then builds the dominator tree
+ */
+void ControlFlowGraph::buildDominators() {
+    dominators.assign(getBlockCount(), NO_BLOCK);
+    dominators[getEntry()] = getEntry();
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (uint32_t i = 1; i < order.size(); i++) {
+            uint32_t block = order[i];
+            uint32_t dominator = NO_BLOCK;
+
+            //Intersects the dominators of each predecessor already processed
+            for (uint32_t predecessor : getPredecessors(block)) {
+                if (dominators[predecessor] == NO_BLOCK) continue;
+                dominator = (dominator == NO_BLOCK) ? predecessor : intersect(predecessor, dominator);
+            }
+
+            if (dominators[block] != dominator) {
+                dominators[block] = dominator;
+                changed = true;
+            }
+        }
+    }
+
+    //Counts the children of each block in the dominator tree, then places them contiguously
+    childStarts.assign(getBlockCount() + 1, 0);
+    for (uint32_t block = 0; block < getBlockCount(); block++) {
+        if (block != getEntry() && dominators[block] != NO_BLOCK) childStarts[dominators[block] + 1]++;
+    }
+    for (uint32_t block = 0; block < getBlockCount(); block++) {
+        childStarts[block + 1] += childStarts[block];
+    }
+
+    children.assign(childStarts.back(), NO_BLOCK);
+    std::vector<uint32_t> next(childStarts.begin(), childStarts.end() - 1);
+    for (uint32_t block = 0; block < getBlockCount(); block++) {
+        if (block != getEntry() && dominators[block] != NO_BLOCK) children[next[dominators[block]]++] = block;
+    }
+
+    //Numbers the dominator tree in preorder and postorder
+    preorder.assign(getBlockCount(), NO_BLOCK);
+    postorder.assign(getBlockCount(), NO_BLOCK);
+    uint32_t pre = 0;
+    uint32_t post = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+    stack.emplace_back(getEntry(), childStarts[getEntry()]);
+    preorder[getEntry()] = pre++;
+
+    while (!stack.empty()) {
+        std::pair<uint32_t, uint32_t>& top = stack.back();
+
+        if (top.second < childStarts[top.first + 1]) {
+            uint32_t child = children[top.second++];
+            preorder[child] = pre++;
+            stack.emplace_back(child, childStarts[child]);
+        } else {
+            postorder[top.first] = post++;
+            stack.pop_back();
+        }
+    }
+}
+
+/**
+ * Finds the nearest common dominator of two blocks, walking up from whichever is later in reverse postorder
+ * @param first - block
+ * @param second - block
+ * @return nearest block dominating both
+ */
+uint32_t ControlFlowGraph::intersect(uint32_t first, uint32_t second) const {
+    while (first != second) {
+        while (orderIndices[first] > orderIndices[second]) first = dominators[first];
+        while (orderIndices[second] > orderIndices[first]) second = dominators[second];
+    }
+
+    return first;
+}
+
+/**
+ * Getter for number of blocks
+ * @return number of blocks
+ */
+uint32_t ControlFlowGraph::getBlockCount() const {
+    return starts.size() - 1;
+}
+
+/**
+ * Getter for entry block
+ * @return block of BeginProg/BeginFunc instruction
+ */
+uint32_t ControlFlowGraph::getEntry() const {
+    return 0;
+}
+
+/**
+ * Getter for exit block
+ * @return block of EndProg/EndFunc instruction
+ */
+uint32_t ControlFlowGraph::getExit() const {
+    return getBlockCount() - 1;
+}
+
+/**
+ * Getter for index of first instruction of a block
+ * @param block - number of block
+ * @return index of first instruction
+ */
+uint32_t ControlFlowGraph::getBegin(uint32_t block) const {
+    return starts[block];
+}
+
+/**
+ * Getter for index after last instruction of a block
+ * @param block - number of block
+ * @return index after last instruction
+ */
+uint32_t ControlFlowGraph::getEnd(uint32_t block) const {
+    return starts[block + 1];
+}
+
+/**
+ * Getter for block containing an instruction
+ * @param instruction - index of instruction
+ * @return number of block
+ */
+uint32_t ControlFlowGraph::getBlock(uint32_t instruction) const {
+    return blocks[instruction];
+}
+
+/**
+ * Getter for successors of a block
+ * @param block - number of block
+ * @return fall through or only successor, then branch target of an IfZ (either may be NO_BLOCK)
+ */
+const std::array<uint32_t, 2> &ControlFlowGraph::getSuccessors(uint32_t block) const {
+    return successors[block];
+}
+
+/**
+ * Getter for predecessors of a block
+ * @param block - number of block
+ * @return predecessors, in order of block number
+ */
+BlockRange ControlFlowGraph::getPredecessors(uint32_t block) const {
+    return BlockRange(predecessors.data() + predecessorStarts[block], predecessors.data() + predecessorStarts[block + 1]);
+}
+
+/**
+ * Getter for reachable blocks in reverse postorder
+ * @return order
+ */
+const std::vector<uint32_t> &ControlFlowGraph::getReversePostorder() const {
+    return order;
+}
+
+/**
+ * Returns whether a block is reachable from the entry block
+ * @param block - number of block
+ * @return whether block is reachable
+ */
+bool ControlFlowGraph::isReachable(uint32_t block) const {
+    return orderIndices[block] != NO_BLOCK;
+}
+
+/**
+ * Getter for immediate dominator of a block
+ * @param block - number of block
+ * @return immediate dominator (the entry block for itself, NO_BLOCK if unreachable)
+ */
+uint32_t ControlFlowGraph::getImmediateDominator(uint32_t block) const {
+    return dominators[block];
+}
+
+/**
+ * Getter for children of a block in the dominator tree
+ * @param block - number of block
+ * @return blocks immediately dominated by block
+ */
+BlockRange ControlFlowGraph::getDominatorChildren(uint32_t block) const {
+    return BlockRange(children.data() + childStarts[block], children.data() + childStarts[block + 1]);
+}
+
+/**
+ * Returns whether one block dominates another, comparing their positions in the dominator tree
+ * @param dominator - block which may dominate
+ * @param block - block which may be dominated
+ * @return whether every path from the entry to block passes through dominator
+ */
+bool ControlFlowGraph::dominates(uint32_t dominator, uint32_t block) const {
+    if (!isReachable(dominator) || !isReachable(block)) return dominator == block;
+
+    return preorder[dominator] <= preorder[block] && postorder[block] <= postorder[dominator];
+}
+
+/**
+ * Prints the blocks, edges and immediate dominators of the graph
+ * @param program - storing names of labels
+ * @param routine - which graph was built from
+ */
+void ControlFlowGraph::print(const Program &program, const Routine &routine) const {
+    std::cout << routine.getName(program) << ":" << std::endl;
+
+    for (uint32_t block = 0; block < getBlockCount(); block++) {
+        std::string line = " B" + std::to_string(block) + " [" + std::to_string(getBegin(block)) + ", "
+                           + std::to_string(getEnd(block)) + ")";
+
+        line += " successors:";
+        for (uint32_t successor : getSuccessors(block)) {
+            if (successor != NO_BLOCK) line += " B" + std::to_string(successor);
+        }
+
+        line += " predecessors:";
+        for (uint32_t predecessor : getPredecessors(block)) {
+            line += " B" + std::to_string(predecessor);
+        }
+
+        line += " dominator: ";
+        line += isReachable(block) ? "B" + std::to_string(getImmediateDominator(block)) : "unreachable";
+
+        std::cout << line << std::endl;
+    }
+}
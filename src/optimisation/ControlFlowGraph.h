@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "Routine.h"
+
+/**
+ * View over a contiguous run of block numbers, so that edge lists can be iterated with range-based for loops
+ */
+class BlockRange {
+private:
+    const uint32_t* first;
+    const uint32_t* last;
+public:
+    //Constructor
+    BlockRange(const uint32_t* first, const uint32_t* last) : first(first), last(last) {}
+
+    const uint32_t* begin() const { return first; }
+
+    const uint32_t* end() const { return last; }
+
+    //Gets the number of blocks in range
+    unsigned long size() const { return last - first; }
+
+    //Returns whether range is empty
+    bool empty() const { return first == last; }
+};
+
+/**
+ * Control flow graph of a routine, splitting its instructions into basic blocks at labels and after
+ * IfZ, Goto, Return and BeginFunc/BeginProg instructions, with EndFunc/EndProg in an exit block of its own.
+ * Blocks are numbered in order of instructions, with the entry block first and the exit block last.
+ * Edges, reverse postorder and the dominator tree are stored in flat arrays and rebuilt in linear time
+ */
+class ControlFlowGraph {
+public:
+    //Block number used for a missing successor or dominator
+    static constexpr uint32_t NO_BLOCK = UINT32_MAX;
+
+private:
+    //Index of the first instruction of each block, followed by the number of instructions
+    std::vector<uint32_t> starts;
+
+    //Block of each instruction
+    std::vector<uint32_t> blocks;
+
+    //Successors of each block: the fall through or only successor, then the branch target of an IfZ
+    std::vector<std::array<uint32_t, 2>> successors;
+
+    //Predecessors of each block, stored contiguously and indexed by predecessorStarts
+    std::vector<uint32_t> predecessors;
+    std::vector<uint32_t> predecessorStarts;
+
+    //Reachable blocks in reverse postorder, and the position of each block in it (NO_BLOCK if unreachable)
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> orderIndices;
+
+    //Immediate dominator of each block (the entry dominates itself, NO_BLOCK if unreachable)
+    std::vector<uint32_t> dominators;
+
+    //Children of each block in the dominator tree, stored contiguously and indexed by childStarts
+    std::vector<uint32_t> children;
+    std::vector<uint32_t> childStarts;
+
+    //Preorder and postorder numbers of each block in the dominator tree, answering dominance in constant time
+    std::vector<uint32_t> preorder;
+    std::vector<uint32_t> postorder;
+
+    //Splits instructions into blocks and links each block to its successors and predecessors
+    void buildBlocks(const Routine& routine);
+
+    //Numbers the reachable blocks in reverse postorder
+    void buildOrder();
+
+    //Finds the immediate dominator of each reachable block and builds the dominator tree
+    void buildDominators();
+
+    //Finds the nearest common dominator of two blocks while building the dominator tree
+    uint32_t intersect(uint32_t first, uint32_t second) const;
+public:
+    //Builds the control flow graph of a routine
+    explicit ControlFlowGraph(const Routine& routine);
+
+    //Getter for number of blocks
+    uint32_t getBlockCount() const;
+
+    //Getter for entry block
+    uint32_t getEntry() const;
+
+    //Getter for exit block
+    uint32_t getExit() const;
+
+    //Getter for index of first instruction of a block
+    uint32_t getBegin(uint32_t block) const;
+
+    //Getter for index after last instruction of a block
+    uint32_t getEnd(uint32_t block) const;
+
+    //Getter for block containing an instruction
+    uint32_t getBlock(uint32_t instruction) const;
+
+    //Getter for successors of a block (either may be NO_BLOCK)
+    const std::array<uint32_t, 2> &getSuccessors(uint32_t block) const;
+
+    //Getter for predecessors of a block
+    BlockRange getPredecessors(uint32_t block) const;
+
+    //Getter for reachable blocks in reverse postorder
+    const std::vector<uint32_t> &getReversePostorder() const;
+
+    //Returns whether a block is reachable from the entry block
+    bool isReachable(uint32_t block) const;
+
+    //Getter for immediate dominator of a block
+    uint32_t getImmediateDominator(uint32_t block) const;
+
+    //Getter for children of a block in the dominator tree
+    BlockRange getDominatorChildren(uint32_t block) const;
+
+    //Returns whether one block dominates another
+    bool dominates(uint32_t dominator, uint32_t block) const;
+
+    //Prints the blocks, edges and immediate dominators of the graph
+    void print(const Program& program, const Routine& routine) const;
+};
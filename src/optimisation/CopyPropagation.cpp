@@ -0,0 +1,115 @@
+#include <algorithm>
+#include "CopyPropagation.h"
+
+/**
+ * Propagates copies through a routine, repeating while replacing copies makes more phi functions copies
+ * @param form - of routine, rewritten in place
+ */
+CopyPropagation::CopyPropagation(SSAForm &form) : form(form), removedCount(0) {
+    while (findCopies()) {
+        replaceCopies();
+    }
+}
+
+/**
+ * Gets the original value of an operand
+ * @param operand - which may be a copy
+ * @return value copied, or operand if it is not a copy
+ */
+Operand CopyPropagation::getOriginal(const Operand &operand) const {
+    auto it = originals.find(operand.getKey());
+    return (it == originals.end()) ? operand : it->second;
+}
+
+/**
+ * Returns whether an operand can replace the copies of it wherever they are used: immediates,
+ * and versions other than temporaries on entry to the routine (which only calls to _ReadLine assign)
+ * @param operand - to check
+ * @return whether operand is fixed
+ */
+bool CopyPropagation::isFixed(const Operand &operand) const {
+    if (operand.isImmediate()) return true;
+
+    return form.isRenamed(operand) && !(operand.getKind() == OperandKind::TEMP && operand.getVersion() == 0);
+}
+
+/**
+ * Removes the copies of the routine, visiting blocks in reverse postorder so that a copy of a copy
+ * is recorded as a copy of the original
+ * @return whether any copy was found
+ */
+bool CopyPropagation::findCopies() {
+    const ControlFlowGraph& graph = form.getGraph();
+    const std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+    bool found = false;
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        std::vector<SSAForm::Phi>& phis = form.getPhis(block);
+
+        for (auto it = phis.begin(); it != phis.end();) {
+            //Finds the only value merged, ignoring the phi function's own result (from loops which do not change it)
+            Operand value;
+            bool copy = true;
+            for (const Operand& argument : it->arguments) {
+                Operand original = getOriginal(argument);
+                if (original == it->result || original == value) continue;
+
+                copy = value.empty();
+                value = original;
+                if (!copy) break;
+            }
+
+            if (copy && !value.empty() && isFixed(value)) {
+                originals[it->result.getKey()] = value;
+                it = phis.erase(it);
+                found = true;
+            } else {
+                it++;
+            }
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            const Instruction& instruction = instructions[i];
+            if (form.isRemoved(i) || instruction.getOp() != Opcode::ASSIGN || !form.isRenamed(instruction.getResult())) continue;
+
+            Operand source = getOriginal(instruction.getArg1().empty() ? instruction.getArg2() : instruction.getArg1());
+            if (!isFixed(source)) continue;
+
+            originals[instruction.getResult().getKey()] = source;
+            form.remove(i);
+            removedCount++;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Replaces the uses of copies in instructions and phi functions with their original values
+ */
+void CopyPropagation::replaceCopies() {
+    const ControlFlowGraph& graph = form.getGraph();
+    std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        for (SSAForm::Phi& phi : form.getPhis(block)) {
+            for (Operand& argument : phi.arguments) {
+                argument = getOriginal(argument);
+            }
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            instructions[i].setArg1(getOriginal(instructions[i].getArg1()));
+            instructions[i].setArg2(getOriginal(instructions[i].getArg2()));
+        }
+    }
+}
+
+/**
+ * Getter for number of copies removed
+ * @return number of copy instructions removed
+ */
+uint32_t CopyPropagation::getRemovedCount() const {
+    return removedCount;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <unordered_map>
+#include "SSA.h"
+
+/**
+ * Copy propagation over a routine in static single assignment form. As versions never change, each use of a
+ * version copied from another version or an immediate can use the original instead, and the copy is removed.
+ * Phi functions whose arguments are all the same value (other than the phi function itself) are copies too.
+ * Copies from variables used by other routines are kept, as calls may change them
+ */
+class CopyPropagation {
+private:
+    //Routine to propagate copies through
+    SSAForm& form;
+
+    //Original value of each version which is a copy
+    std::unordered_map<uint64_t, Operand> originals;
+
+    //Number of copies removed
+    uint32_t removedCount;
+
+    //Gets the original value of an operand
+    Operand getOriginal(const Operand& operand) const;
+
+    //Returns whether an operand can replace the copies of it wherever they are used
+    bool isFixed(const Operand& operand) const;
+
+    //Removes the copies of the routine, recording the value each copied
+    bool findCopies();
+
+    //Replaces the uses of copies with their original values
+    void replaceCopies();
+public:
+    //Propagates copies through a routine in static single assignment form
+    explicit CopyPropagation(SSAForm& form);
+
+    //Getter for number of copies removed
+    uint32_t getRemovedCount() const;
+};
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <unordered_set>
+#include "DeadCodeElimination.h"
+
+/**
+ * Removes dead and unreachable instructions from a routine, rebuilding its control flow graph
+ * and repeating until no more instructions can be removed
+ * @param routine - to remove instructions from
+ * @param nonLocal - whether each variable of the program is used by a routine other than the one declaring it
+ */
+DeadCodeElimination::DeadCodeElimination(Routine &routine, const std::vector<bool> &nonLocal)
+        : routine(routine), nonLocal(nonLocal), removedCount(0) {
+    while (true) {
+        ControlFlowGraph graph(routine);
+        std::vector<bool> removed(routine.getInstructions().size(), false);
+
+        bool changed = findUnreachable(graph, removed);
+        changed |= findDead(graph, removed);
+        changed |= findRedundantBranches(removed);
+        if (!changed) break;
+
+        removedCount += std::count(removed.begin(), removed.end(), true);
+        routine.erase(removed);
+    }
+
+    //Drops the labels which no branch refers to any more, except that of the procedure
+    std::unordered_set<uint32_t> targets;
+    for (const Instruction& instruction : routine.getInstructions()) {
+        if (instruction.getOp() == Opcode::GOTO) targets.insert(instruction.getArg1().getValue());
+        if (instruction.getOp() == Opcode::IFZ) targets.insert(instruction.getResult().getValue());
+    }
+    for (Instruction& instruction : routine.getInstructions()) {
+        if (instruction.getOp() != Opcode::BEGIN_FUNC && !targets.count(instruction.getLabel())) {
+            instruction.setLabel(Instruction::NO_LABEL);
+        }
+    }
+}
+
+/**
+ * Marks the instructions of blocks which cannot be reached from the entry block,
+ * except those beginning and ending the routine
+ * @param graph - of routine
+ * @param removed - whether each instruction is removed
+ * @return whether any instruction was marked
+ */
+bool DeadCodeElimination::findUnreachable(const ControlFlowGraph &graph, std::vector<bool> &removed) const {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    bool changed = false;
+
+    for (uint32_t block = 0; block < graph.getBlockCount(); block++) {
+        if (graph.isReachable(block)) continue;
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            Opcode op = instructions[i].getOp();
+            if (op == Opcode::END_FUNC || op == Opcode::END_PROG || op == Opcode::BEGIN_FUNC || op == Opcode::BEGIN_PROG) continue;
+
+            removed[i] = true;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * Marks assignments to temporaries and local variables which are not live afterwards, finding the
+ * temporaries and variables live on exit from each block, then walking each block backwards so that
+ * the arguments of a dead assignment are not kept alive by it
+ * @param graph - of routine
+ * @param removed - whether each instruction is removed
+ * @return whether any instruction was marked
+ */
+bool DeadCodeElimination::findDead(const ControlFlowGraph &graph, std::vector<bool> &removed) const {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    Liveness liveness(routine, graph, nonLocal, removed);
+    std::vector<uint64_t> live(liveness.getWords());
+    bool changed = false;
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        std::copy(liveness.getLiveOut(block), liveness.getLiveOut(block) + liveness.getWords(), live.begin());
+
+        for (uint32_t i = graph.getEnd(block); i-- > graph.getBegin(block);) {
+            if (removed[i]) continue;
+            const Instruction& instruction = instructions[i];
+            uint32_t index = liveness.getIndex(instruction.getResult());
+
+            if (index != UINT32_MAX) {
+                //Calls are kept for their effects even if the value returned is not used, and divisions which may
+                //fail (by zero) for the runtime error they raise
+                bool assignment = (instruction.getOp() == Opcode::ASSIGN || Opcodes::isOperation(instruction.getOp()))
+                                  && !instruction.mayFail();
+                if (assignment && !Liveness::contains(live.data(), index)) {
+                    removed[i] = true;
+                    changed = true;
+                    continue;
+                }
+                Liveness::erase(live.data(), index);
+            }
+
+            for (const Operand* use : {&instruction.getArg1(), &instruction.getArg2()}) {
+                uint32_t used = liveness.getIndex(*use);
+                if (used != UINT32_MAX) Liveness::insert(live.data(), used);
+            }
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * Marks jumps and conditional branches to the next instruction kept, as control reaches it either way
+ * @param removed - whether each instruction is removed
+ * @return whether any instruction was marked
+ */
+bool DeadCodeElimination::findRedundantBranches(std::vector<bool> &removed) const {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    bool changed = false;
+
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        Opcode op = instructions[i].getOp();
+        if (removed[i] || (op != Opcode::GOTO && op != Opcode::IFZ)) continue;
+        uint32_t target = (op == Opcode::GOTO) ? instructions[i].getArg1().getValue() : instructions[i].getResult().getValue();
+
+        //Labels of removed instructions pass on to the next instruction kept, so also mark the same place
+        for (uint32_t next = i + 1; next < instructions.size(); next++) {
+            if (instructions[next].getLabel() == target) {
+                removed[i] = true;
+                changed = true;
+                break;
+            }
+            if (!removed[next]) break;
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * Getter for number of instructions removed
+ * @return number of instructions removed
+ */
+uint32_t DeadCodeElimination::getRemovedCount() const {
+    return removedCount;
+}
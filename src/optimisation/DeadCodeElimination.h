@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include "Liveness.h"
+
+/**
+ * Removes the instructions of a routine which can never run or whose results are never used, repeating until
+ * nothing more can be removed: blocks which cannot be reached from the entry, assignments to temporaries and
+ * local variables which are not live afterwards, and jumps or conditional branches to the next instruction.
+ * Assignments to variables used by other routines are kept, as calls may read them
+ */
+class DeadCodeElimination {
+private:
+    //Routine to remove instructions from
+    Routine& routine;
+
+    //Whether each variable of the program is used by a routine other than the one declaring it
+    const std::vector<bool>& nonLocal;
+
+    //Number of instructions removed
+    uint32_t removedCount;
+
+    //Marks the instructions of blocks which cannot be reached
+    bool findUnreachable(const ControlFlowGraph& graph, std::vector<bool>& removed) const;
+
+    //Marks assignments whose results are not live afterwards
+    bool findDead(const ControlFlowGraph& graph, std::vector<bool>& removed) const;
+
+    //Marks jumps and conditional branches to the instruction after them
+    bool findRedundantBranches(std::vector<bool>& removed) const;
+public:
+    //Removes dead and unreachable instructions from a routine
+    DeadCodeElimination(Routine& routine, const std::vector<bool>& nonLocal);
+
+    //Getter for number of instructions removed
+    uint32_t getRemovedCount() const;
+};
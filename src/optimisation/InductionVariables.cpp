@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <climits>
+#include "InductionVariables.h"
+
+/**
+ * Reduces the strength of multiplications of induction variables in a routine in static single assignment form
+ * @param program - owning the table of temporaries, which new induction variables are added to
+ * @param form - of routine, rewritten in place (its preheaders inserted beforehand)
+ */
+InductionVariables::InductionVariables(Program &program, SSAForm &form)
+    : program(program), form(form), loops(form), reducedCount(0), eliminatedCount(0) {
+    if (loops.getCount() == 0) return;
+
+    inserted.resize(form.getGraph().getBlockCount());
+    findInductions();
+    eliminateRedundant();
+    reduce();
+    replaceUses();
+    replaceTests();
+
+    if (reducedCount > 0) form.insert(inserted);
+}
+
+/**
+ * Gets the positions of the preheader and latch of a loop in the predecessors of its header, if the loop has
+ * a preheader and a single latch ending in a jump back to the header (so that its exits are before the latch)
+ * @param loop - to find the edges of
+ * @param entry - set to the position of the preheader
+ * @param back - set to the position of the latch
+ * @return whether the loop has a preheader and a single latch
+ */
+bool InductionVariables::findEdges(uint32_t loop, uint32_t &entry, uint32_t &back) const {
+    const ControlFlowGraph& graph = form.getGraph();
+    const Loops::Loop& current = loops.getLoop(loop);
+    if (current.preheader == ControlFlowGraph::NO_BLOCK || current.latches.size() != 1) return false;
+
+    uint32_t last = graph.getEnd(current.latches[0]) - 1;
+    if (form.isRemoved(last) || form.getRoutine().getInstructions()[last].getOp() != Opcode::GOTO) return false;
+
+    uint32_t position = 0;
+    entry = back = UINT32_MAX;
+    for (uint32_t predecessor : graph.getPredecessors(current.header)) {
+        if (predecessor == current.preheader) entry = position;
+        if (predecessor == current.latches[0]) back = position;
+        position++;
+    }
+
+    return position == 2 && entry != UINT32_MAX && back != UINT32_MAX;
+}
+
+/**
+ * Finds the block defining each version, and the basic induction variables of each loop: phi functions at its header whose version from the latch
+ * is defined inside the loop by adding an integer immediate to (or subtracting one from) the phi function's own
+ */
+void InductionVariables::findInductions() {
+    const ControlFlowGraph& graph = form.getGraph();
+    const std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+
+    std::unordered_map<uint64_t, uint32_t> definitions;
+    for (uint32_t block = 0; block < graph.getBlockCount(); block++) {
+        for (const SSAForm::Phi& phi : form.getPhis(block)) {
+            blocks[phi.result.getKey()] = block;
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (!form.isRemoved(i) && form.isRenamed(instructions[i].getResult())) {
+                definitions[instructions[i].getResult().getKey()] = i;
+                blocks[instructions[i].getResult().getKey()] = block;
+            }
+        }
+    }
+
+    for (uint32_t loop = 0; loop < loops.getCount(); loop++) {
+        uint32_t entry, back;
+        if (!findEdges(loop, entry, back)) continue;
+
+        for (const SSAForm::Phi& phi : form.getPhis(loops.getLoop(loop).header)) {
+            //Updates inside an inner loop may run more than once on each iteration
+            auto it = definitions.find(phi.arguments[back].getKey());
+            if (it == definitions.end() || loops.getInnermost(graph.getBlock(it->second)) != loop) continue;
+
+            //Steps are negated as unsigned integers, so subtracting the smallest integer wraps around to adding it
+            const Instruction& update = instructions[it->second];
+            const Operand& arg1 = update.getArg1();
+            const Operand& arg2 = update.getArg2();
+            int32_t step;
+            if (update.getOp() == Opcode::PLUS && arg1 == phi.result && arg2.getKind() == OperandKind::INT) {
+                step = arg2.getInt();
+            } else if (update.getOp() == Opcode::PLUS && arg2 == phi.result && arg1.getKind() == OperandKind::INT) {
+                step = arg1.getInt();
+            } else if (update.getOp() == Opcode::MINUS && arg1 == phi.result && arg2.getKind() == OperandKind::INT) {
+                step = static_cast<int32_t>(0u - arg2.getValue());
+            } else {
+                continue;
+            }
+
+            inductions[phi.result.getKey()] = {loop, phi.result, phi.arguments[entry], update.getResult(), it->second,
+                                               step, {}};
+        }
+    }
+}
+
+/**
+ * Replaces induction variables with the same start and step as an earlier one in the same loop, which always
+ * have the same value as it. The update of a replaced variable is kept if its result is used other than by its
+ * phi function, as it may be used before the update of the one replacing it
+ */
+void InductionVariables::eliminateRedundant() {
+    const std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+
+    std::unordered_map<uint64_t, uint32_t> uses;
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        if (form.isRemoved(i)) continue;
+        uses[instructions[i].getArg1().getKey()]++;
+        uses[instructions[i].getArg2().getKey()]++;
+    }
+    for (uint32_t block = 0; block < form.getGraph().getBlockCount(); block++) {
+        for (const SSAForm::Phi& phi : form.getPhis(block)) {
+            for (const Operand& argument : phi.arguments) {
+                uses[argument.getKey()]++;
+            }
+        }
+    }
+
+    for (uint32_t loop = 0; loop < loops.getCount(); loop++) {
+        std::vector<SSAForm::Phi>& phis = form.getPhis(loops.getLoop(loop).header);
+        std::vector<const Induction*> kept;
+
+        for (auto it = phis.begin(); it != phis.end();) {
+            auto found = inductions.find(it->result.getKey());
+            if (found == inductions.end()) {
+                it++;
+                continue;
+            }
+
+            Induction& induction = found->second;
+            const Induction* same = nullptr;
+            for (const Induction* other : kept) {
+                if (other->initial == induction.initial && other->step == induction.step) same = other;
+            }
+            if (same == nullptr) {
+                kept.push_back(&induction);
+                it++;
+                continue;
+            }
+
+            replacements[induction.value.getKey()] = same->value;
+            if (uses[induction.next.getKey()] == 1) form.remove(induction.update);
+            it = phis.erase(it);
+            eliminatedCount++;
+        }
+    }
+
+    for (auto it = inductions.begin(); it != inductions.end();) {
+        it = replacements.count(it->first) ? inductions.erase(it) : std::next(it);
+    }
+}
+
+/**
+ * Returns whether an operand has the same value on every iteration of a loop: immediates, versions defined
+ * outside the loop, and versions on entry to the routine (other than temporaries only assigned by calls)
+ * @param operand - to check
+ * @param loop - operand is used in
+ * @return whether operand is invariant
+ */
+bool InductionVariables::isInvariant(const Operand &operand, uint32_t loop) const {
+    if (operand.isImmediate()) return true;
+    if (!form.isRenamed(operand)) return false;
+
+    auto it = blocks.find(operand.getKey());
+    if (it == blocks.end()) return operand.getVersion() == 0 && operand.getKind() != OperandKind::TEMP;
+
+    return !loops.contains(loop, it->second);
+}
+
+/**
+ * Replaces each multiplication of an induction variable by a loop invariant integer inside its loop with a new
+ * induction variable, starting at the initial value times the factor and increased by the step times the factor
+ * at the end of the latch. Products are folded when both sides are immediates, and otherwise multiplied once in
+ * the preheader. Multiplications of the same induction variable by the same factor share one new induction variable
+ */
+void InductionVariables::reduce() {
+    const ControlFlowGraph& graph = form.getGraph();
+    const std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        if (loops.getInnermost(block) == Loops::NO_LOOP) continue;
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            const Instruction& instruction = instructions[i];
+            if (form.isRemoved(i) || instruction.getOp() != Opcode::MULTIPLY || !form.isRenamed(instruction.getResult())) continue;
+
+            //Multiplication is commutative, so the induction variable may be either argument
+            Operand arg1 = getReplacement(instruction.getArg1());
+            Operand arg2 = getReplacement(instruction.getArg2());
+            bool first = inductions.count(arg1.getKey()) > 0;
+            Operand factor = first ? arg2 : arg1;
+
+            auto it = inductions.find((first ? arg1 : arg2).getKey());
+            if (it == inductions.end()) continue;
+
+            Induction& induction = it->second;
+            if (!loops.contains(induction.loop, block) || !isInvariant(factor, induction.loop)) continue;
+
+            auto found = std::find_if(induction.products.begin(), induction.products.end(),
+                                      [&factor](const std::pair<Operand, Operand>& derived) { return derived.first == factor; });
+            Operand product = (found == induction.products.end()) ? addProduct(induction, factor) : found->second;
+
+            replacements[instruction.getResult().getKey()] = product;
+            form.remove(i);
+            reducedCount++;
+        }
+    }
+}
+
+/**
+ * Adds an induction variable equal to another times a loop invariant factor, with a phi function at the header
+ * merging its initial value from the preheader and its value increased by the step times the factor from the latch
+ * @param induction - basic induction variable multiplied
+ * @param factor - loop invariant integer multiplied by
+ * @return version defined by the new phi function
+ */
+Operand InductionVariables::addProduct(Induction &induction, const Operand &factor) {
+    uint32_t entry, back;
+    findEdges(induction.loop, entry, back);
+    const Loops::Loop& loop = loops.getLoop(induction.loop);
+    Operand temp = program.addTemp();
+
+    Operand initial = temp.withVersion(3);
+    Operand delta = temp.withVersion(4);
+    if (factor.getKind() == OperandKind::INT) {
+        delta = Operand::integer(multiply(induction.step, factor.getInt()));
+    } else {
+        inserted[loop.preheader].emplace_back(Opcode::MULTIPLY, Operand::integer(induction.step), factor, delta);
+    }
+    if (factor.getKind() == OperandKind::INT && induction.initial.getKind() == OperandKind::INT) {
+        initial = Operand::integer(multiply(induction.initial.getInt(), factor.getInt()));
+    } else {
+        inserted[loop.preheader].emplace_back(Opcode::MULTIPLY, induction.initial, factor, initial);
+    }
+
+    SSAForm::Phi phi {temp.withVersion(1), std::vector<Operand>(2)};
+    phi.arguments[entry] = initial;
+    phi.arguments[back] = temp.withVersion(2);
+    form.getPhis(loop.header).push_back(phi);
+    inserted[loop.latches[0]].emplace_back(Opcode::PLUS, phi.result, delta, temp.withVersion(2));
+
+    induction.products.emplace_back(factor, phi.result);
+    return phi.result;
+}
+
+/**
+ * Gets the version replacing another
+ * @param operand - which may have been replaced
+ * @return version replacing operand, or operand if it has not been replaced
+ */
+Operand InductionVariables::getReplacement(const Operand &operand) const {
+    auto it = replacements.find(operand.getKey());
+    return (it == replacements.end()) ? operand : it->second;
+}
+
+/**
+ * Replaces the uses of replaced versions in instructions and phi functions, including the instructions to be
+ * inserted and the initial values of induction variables (which may start from a product already replaced)
+ */
+void InductionVariables::replaceUses() {
+    std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+    if (replacements.empty()) return;
+
+    for (auto& entry : inductions) {
+        entry.second.initial = getReplacement(entry.second.initial);
+    }
+
+    for (uint32_t block = 0; block < form.getGraph().getBlockCount(); block++) {
+        for (SSAForm::Phi& phi : form.getPhis(block)) {
+            for (Operand& argument : phi.arguments) {
+                argument = getReplacement(argument);
+            }
+        }
+    }
+
+    for (Instruction& instruction : instructions) {
+        instruction.setArg1(getReplacement(instruction.getArg1()));
+        instruction.setArg2(getReplacement(instruction.getArg2()));
+    }
+    for (std::vector<Instruction>& block : inserted) {
+        for (Instruction& instruction : block) {
+            instruction.setArg1(getReplacement(instruction.getArg1()));
+            instruction.setArg2(getReplacement(instruction.getArg2()));
+        }
+    }
+}
+
+/**
+ * Replaces tests of counters whose only other use is their own update (e.g. i < 10, where i only counts
+ * iterations) with tests of an induction variable derived from them, then removes the counter. Only counters
+ * starting at an immediate and counting up towards an immediate bound are replaced, by a positive multiple of
+ * them, where neither the start nor the bound past the last step overflow when multiplied, so that the test
+ * gives the same result on every iteration
+ */
+void InductionVariables::replaceTests() {
+    std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+
+    std::unordered_map<uint64_t, std::vector<uint32_t>> uses;
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        if (form.isRemoved(i)) continue;
+        uses[instructions[i].getArg1().getKey()].push_back(i);
+        if (instructions[i].getArg2() != instructions[i].getArg1()) uses[instructions[i].getArg2().getKey()].push_back(i);
+    }
+
+    std::unordered_map<uint64_t, uint32_t> phiUses;
+    for (uint32_t block = 0; block < form.getGraph().getBlockCount(); block++) {
+        for (const SSAForm::Phi& phi : form.getPhis(block)) {
+            for (const Operand& argument : phi.arguments) {
+                phiUses[argument.getKey()]++;
+            }
+        }
+    }
+
+    for (auto& entry : inductions) {
+        Induction& induction = entry.second;
+        if (induction.products.empty() || induction.step <= 0 || induction.initial.getKind() != OperandKind::INT
+            || phiUses[induction.value.getKey()] != 0 || phiUses[induction.next.getKey()] != 1
+            || !uses[induction.next.getKey()].empty()) continue;
+
+        //The only uses of the counter should be its update and a single test against an immediate bound
+        uint32_t test = UINT32_MAX;
+        bool other = false;
+        for (uint32_t use : uses[induction.value.getKey()]) {
+            if (use == induction.update) continue;
+
+            const Instruction& instruction = instructions[use];
+            bool compares = instruction.getOp() == Opcode::LT || instruction.getOp() == Opcode::LTE;
+            if (test != UINT32_MAX || !compares || instruction.getArg1() != induction.value
+                || instruction.getArg2().getKind() != OperandKind::INT) other = true;
+            test = use;
+        }
+        if (other || test == UINT32_MAX) continue;
+
+        //Chooses the smallest positive multiple, which is the least likely to overflow
+        int32_t factor = 0;
+        Operand product;
+        for (const auto& derived : induction.products) {
+            int32_t multiple = derived.first.getInt();
+            if (derived.first.getKind() == OperandKind::INT && multiple > 0 && (factor == 0 || multiple < factor)) {
+                factor = multiple;
+                product = derived.second;
+            }
+        }
+        if (factor == 0) continue;
+
+        int64_t bound = instructions[test].getArg2().getInt();
+        int64_t first = static_cast<int64_t>(induction.initial.getInt()) * factor;
+        int64_t last = (bound + induction.step) * factor;
+        if (first < INT_MIN || first > INT_MAX || last < INT_MIN || last > INT_MAX) continue;
+
+        instructions[test].setArg1(product);
+        instructions[test].setArg2(Operand::integer(static_cast<int32_t>(bound * factor)));
+        eliminate(induction);
+    }
+}
+
+/**
+ * Removes an induction variable, whose phi function and update are no longer used
+ * @param induction - to remove
+ */
+void InductionVariables::eliminate(Induction &induction) {
+    std::vector<SSAForm::Phi>& phis = form.getPhis(loops.getLoop(induction.loop).header);
+
+    for (auto it = phis.begin(); it != phis.end(); it++) {
+        if (it->result == induction.value) {
+            phis.erase(it);
+            break;
+        }
+    }
+
+    form.remove(induction.update);
+    eliminatedCount++;
+}
+
+/**
+ * Multiplies two integers, wrapping around on overflow as the program would
+ * @param first - first integer
+ * @param second - second integer
+ * @return product of integers
+ */
+int32_t InductionVariables::multiply(int32_t first, int32_t second) {
+    return static_cast<int32_t>(static_cast<uint32_t>(first) * static_cast<uint32_t>(second));
+}
+
+/**
+ * Getter for number of multiplications replaced
+ * @return number of multiplications replaced by additions
+ */
+uint32_t InductionVariables::getReducedCount() const {
+    return reducedCount;
+}
+
+/**
+ * Getter for number of induction variables removed
+ * @return number of induction variables removed
+ */
+uint32_t InductionVariables::getEliminatedCount() const {
+    return eliminatedCount;
+}
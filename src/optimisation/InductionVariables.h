@@ -0,0 +1,110 @@
+#pragma once
+
+#include <unordered_map>
+#include "Loops.h"
+
+/**
+ * Induction variable analysis and strength reduction over a routine in static single assignment form.
+ * A basic induction variable is a phi function at a loop header whose value from the loop is its own value plus
+ * or minus an integer immediate (e.g. i := i + 1). Each multiplication of one by a loop invariant integer is
+ * replaced by a new induction variable, started at the product in the preheader and increased by the step times
+ * the factor at the end of the loop. Induction variables with the same start and step as another are replaced by
+ * it, and a counter only left to test a bound against is replaced in the test by a new one, then removed.
+ * Only loops with a preheader and a single jump back to the header are changed. Integers wrap around on overflow,
+ * so additions compute the same values as the multiplications they replace
+ */
+class InductionVariables {
+private:
+    //Basic induction variable of a loop
+    struct Induction {
+        //Loop which the variable is increased by
+        uint32_t loop;
+
+        //Version defined by the phi function at the header
+        Operand value;
+
+        //Value on entry to the loop
+        Operand initial;
+
+        //Version defined by increasing the value, merged by the phi function
+        Operand next;
+
+        //Instruction defining the next version
+        uint32_t update;
+
+        //Amount added on each iteration
+        int32_t step;
+
+        //Induction variables replacing multiplications of this one, with the factor multiplied by
+        std::vector<std::pair<Operand, Operand>> products;
+    };
+
+    //Program owning the table of temporaries, which new induction variables are added to
+    Program& program;
+
+    //Routine to reduce multiplications in
+    SSAForm& form;
+
+    //Loops of routine
+    Loops loops;
+
+    //Block defining each version, by key (versions on entry are not stored)
+    std::unordered_map<uint64_t, uint32_t> blocks;
+
+    //Basic induction variables, by key of the version defined by their phi function
+    std::unordered_map<uint64_t, Induction> inductions;
+
+    //Versions replaced by others, by key
+    std::unordered_map<uint64_t, Operand> replacements;
+
+    //Instructions to insert at the end of each block
+    std::vector<std::vector<Instruction>> inserted;
+
+    //Number of multiplications replaced
+    uint32_t reducedCount;
+
+    //Number of induction variables removed
+    uint32_t eliminatedCount;
+
+    //Gets the positions of the preheader and latch of a loop in the predecessors of its header
+    bool findEdges(uint32_t loop, uint32_t& entry, uint32_t& back) const;
+
+    //Finds the block defining each version, and the basic induction variables of each loop
+    void findInductions();
+
+    //Replaces induction variables with the same start and step as another in the same loop
+    void eliminateRedundant();
+
+    //Returns whether an operand has the same value on every iteration of a loop
+    bool isInvariant(const Operand& operand, uint32_t loop) const;
+
+    //Replaces multiplications of induction variables by loop invariant integers with new induction variables
+    void reduce();
+
+    //Adds an induction variable equal to another times a loop invariant factor
+    Operand addProduct(Induction& induction, const Operand& factor);
+
+    //Gets the version replacing another
+    Operand getReplacement(const Operand& operand) const;
+
+    //Replaces the uses of replaced versions
+    void replaceUses();
+
+    //Replaces tests of counters only used to test them with tests of the induction variables derived from them
+    void replaceTests();
+
+    //Removes an induction variable, whose phi function and update are no longer used
+    void eliminate(Induction& induction);
+
+    //Multiplies two integers, wrapping around on overflow
+    static int32_t multiply(int32_t first, int32_t second);
+public:
+    //Reduces the strength of multiplications of induction variables in a routine in static single assignment form
+    InductionVariables(Program& program, SSAForm& form);
+
+    //Getter for number of multiplications replaced
+    uint32_t getReducedCount() const;
+
+    //Getter for number of induction variables removed
+    uint32_t getEliminatedCount() const;
+};
@@ -0,0 +1,302 @@
+#include "Inliner.h"
+#include "SSA.h"
+
+/**
+ * Inlines calls between the routines of a program, visiting callees before their callers
+ * @param program - owning the tables of operands, which new temporaries and labels are added to
+ * @param routines - of program, rewritten in place (procedures whose calls were all inlined are removed)
+ */
+Inliner::Inliner(Program &program, std::vector<Routine> &routines)
+    : program(program), routines(routines), inlinedCount(0), removedCount(0) {
+    for (uint32_t i = 0; i < routines.size(); i++) {
+        if (!routines[i].isProgram()) indices[routines[i].getLabel()] = i;
+    }
+    for (uint32_t i = 0; i < program.getVariableCount(); i++) {
+        const std::shared_ptr<Symbol>& procedure = program.getVariable(Operand(OperandKind::VARIABLE, i))->getProcedure();
+        owners.push_back(program.getProcedureLabel(procedure.get()));
+    }
+
+    findCalls();
+    findInlinable(SSAForm::findNonLocalVariables(program, routines));
+
+    inlined.assign(routines.size(), false);
+    for (uint32_t caller : getPostorder()) {
+        inlineCalls(caller);
+    }
+
+    removeProcedures();
+}
+
+/**
+ * Finds the routines called by each routine, and the number of calls to each (library functions are not routines)
+ */
+void Inliner::findCalls() {
+    callees.assign(routines.size(), {});
+    callCounts.assign(routines.size(), 0);
+
+    for (uint32_t i = 0; i < routines.size(); i++) {
+        for (const Instruction& instruction : routines[i].getInstructions()) {
+            if (instruction.getOp() != Opcode::CALL) continue;
+
+            auto it = indices.find(instruction.getArg2().getValue());
+            if (it == indices.end()) continue;
+
+            callees[i].push_back(it->second);
+            callCounts[it->second]++;
+        }
+    }
+}
+
+/**
+ * Finds the routines which can be inlined: procedures which cannot call themselves through any chain of calls,
+ * and whose variables are not used by the procedures declared inside them (which would no longer see them)
+ * @param nonLocal - whether each variable of the program is used by a routine other than the one declaring it
+ */
+void Inliner::findInlinable(const std::vector<bool> &nonLocal) {
+    inlinable.assign(routines.size(), false);
+
+    for (uint32_t i = 0; i < routines.size(); i++) {
+        if (routines[i].isProgram()) continue;
+
+        //Searches the routines reachable by calls for this one
+        std::vector<bool> visited(routines.size(), false);
+        std::vector<uint32_t> stack(callees[i]);
+        bool recursive = false;
+        while (!stack.empty() && !recursive) {
+            uint32_t routine = stack.back();
+            stack.pop_back();
+            recursive = routine == i;
+            if (visited[routine]) continue;
+
+            visited[routine] = true;
+            stack.insert(stack.end(), callees[routine].begin(), callees[routine].end());
+        }
+
+        inlinable[i] = !recursive;
+    }
+
+    for (uint32_t i = 0; i < owners.size(); i++) {
+        auto it = indices.find(owners[i]);
+        if (nonLocal[i] && it != indices.end()) inlinable[it->second] = false;
+    }
+}
+
+/**
+ * Gets the routines in postorder of calls from each in turn, so that each comes after those it calls
+ * (other than those calling it back, which are not inlined)
+ * @return indices of routines, each after the routines it calls
+ */
+std::vector<uint32_t> Inliner::getPostorder() const {
+    std::vector<uint32_t> postorder;
+    std::vector<bool> visited(routines.size(), false);
+    //Routines being visited, with the position of the next callee to visit
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+    for (uint32_t root = 0; root < routines.size(); root++) {
+        if (visited[root]) continue;
+        visited[root] = true;
+        stack.emplace_back(root, 0);
+
+        while (!stack.empty()) {
+            std::pair<uint32_t, uint32_t>& top = stack.back();
+
+            if (top.second < callees[top.first].size()) {
+                uint32_t callee = callees[top.first][top.second++];
+                if (!visited[callee]) {
+                    visited[callee] = true;
+                    stack.emplace_back(callee, 0);
+                }
+            } else {
+                postorder.push_back(top.first);
+                stack.pop_back();
+            }
+        }
+    }
+
+    return postorder;
+}
+
+/**
+ * Inlines the calls of a routine to procedures which can be inlined, if small or called from nowhere else.
+ * The parameters pushed, the call and the parameters popped are removed, passing their labels on
+ * @param caller - index of routine to inline calls of
+ */
+void Inliner::inlineCalls(uint32_t caller) {
+    std::vector<Instruction>& instructions = routines[caller].getInstructions();
+    std::vector<Instruction> rewritten;
+    std::vector<bool> removed;
+    rewritten.reserve(instructions.size());
+    removed.reserve(instructions.size());
+
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        const Instruction& instruction = instructions[i];
+        rewritten.push_back(instruction);
+        removed.push_back(false);
+        if (instruction.getOp() != Opcode::CALL) continue;
+
+        auto it = indices.find(instruction.getArg2().getValue());
+        if (it == indices.end() || !inlinable[it->second] || it->second == caller) continue;
+
+        const Routine& callee = routines[it->second];
+        if (callee.getInstructions().size() - 2 > SIZE_LIMIT && callCounts[it->second] != 1) continue;
+
+        //Parameters are pushed in reverse, so the first is the last pushed
+        std::vector<Operand> formals = program.getParameters(callee.getLabel());
+        if (formals.size() >= rewritten.size()) continue;
+
+        std::vector<Operand> arguments;
+        for (unsigned long j = rewritten.size() - 2; arguments.size() < formals.size(); j--) {
+            if (rewritten[j].getOp() != Opcode::PUSH_PARAM) break;
+            arguments.push_back(rewritten[j].getArg2());
+        }
+        if (arguments.size() != formals.size()) continue;
+
+        std::fill(removed.end() - formals.size() - 1, removed.end(), true);
+        expand(callee, arguments, instruction.getResult(), rewritten, removed);
+        inlined[it->second] = true;
+        inlinedCount++;
+
+        if (i + 1 < instructions.size() && instructions[i + 1].getOp() == Opcode::POP_PARAMS) {
+            rewritten.push_back(instructions[++i]);
+            removed.push_back(true);
+        }
+    }
+
+    instructions.swap(rewritten);
+    routines[caller].erase(removed);
+}
+
+/**
+ * Appends a copy of a procedure's body, assigning the arguments to its parameters and the value returned to the
+ * call's result. Its temporaries and variables are replaced by new temporaries, and its labels by new labels.
+ * Its EndFunc instruction is appended as removed, labelled as the target of jumps past the copy, so that the
+ * label is passed on to the instruction after the call
+ * @param callee - routine of procedure called
+ * @param arguments - values of parameters, in order
+ * @param result - temporary storing the value returned
+ * @param rewritten - instructions to append the copy to
+ * @param removed - whether each instruction appended is removed
+ */
+void Inliner::expand(const Routine &callee, const std::vector<Operand> &arguments, const Operand &result,
+                     std::vector<Instruction> &rewritten, std::vector<bool> &removed) {
+    const std::vector<Instruction>& body = callee.getInstructions();
+    std::unordered_map<uint64_t, Operand> temps;
+    std::unordered_map<uint32_t, uint32_t> labels;
+
+    //Variables of enclosing routines are shared with the procedure, so are left as they are
+    auto rename = [this, &callee, &temps](const Operand& operand) {
+        bool local = operand.getKind() == OperandKind::TEMP
+                     || (operand.getKind() == OperandKind::VARIABLE && owners[operand.getValue()] == callee.getLabel());
+        if (!local) return operand;
+
+        Operand& temp = temps[operand.getStorageKey()];
+        if (temp.empty()) temp = program.addTemp();
+        return temp;
+    };
+    auto relabel = [&labels](uint32_t label) {
+        auto it = labels.find(label);
+        return (it == labels.end()) ? label : it->second;
+    };
+
+    for (unsigned long i = 1; i < body.size(); i++) {
+        if (body[i].hasLabel()) labels[body[i].getLabel()] = program.addLabel().getValue();
+    }
+    Instruction end = body.back();
+    if (!end.hasLabel()) end.setLabel(program.addLabel().getValue());
+    end.setLabel(relabel(end.getLabel()));
+
+    std::vector<Operand> formals = program.getParameters(callee.getLabel());
+    for (unsigned long i = 0; i < formals.size(); i++) {
+        if (formals[i].empty()) continue;
+
+        rewritten.emplace_back(Opcode::ASSIGN, arguments[i], Operand(), rename(formals[i]));
+        removed.push_back(false);
+    }
+
+    for (unsigned long i = 1; i + 1 < body.size(); i++) {
+        Instruction copy = body[i];
+        if (copy.hasLabel()) copy.setLabel(relabel(copy.getLabel()));
+
+        if (copy.getOp() == Opcode::RETURN) {
+            //The last instruction of the body falls through to the instruction after the call
+            Instruction assignment(Opcode::ASSIGN, rename(copy.getArg2()), Operand(), result);
+            assignment.setLabel(copy.getLabel());
+            rewritten.push_back(assignment);
+            removed.push_back(false);
+
+            if (i + 2 < body.size()) {
+                rewritten.emplace_back(Opcode::GOTO, Operand(OperandKind::LABEL, end.getLabel()), Operand(), Operand());
+                removed.push_back(false);
+            }
+            continue;
+        }
+
+        if (copy.getOp() == Opcode::GOTO) {
+            copy.setArg1(Operand(OperandKind::LABEL, relabel(copy.getArg1().getValue())));
+        } else if (copy.getOp() == Opcode::IFZ) {
+            copy.setArg1(rename(copy.getArg1()));
+            copy.setResult(Operand(OperandKind::LABEL, relabel(copy.getResult().getValue())));
+        } else {
+            copy.setArg1(rename(copy.getArg1()));
+            if (copy.getOp() != Opcode::CALL) copy.setArg2(rename(copy.getArg2()));
+            copy.setResult(rename(copy.getResult()));
+        }
+        rewritten.push_back(copy);
+        removed.push_back(false);
+    }
+
+    rewritten.push_back(end);
+    removed.push_back(true);
+}
+
+/**
+ * Removes procedures whose calls were all inlined, repeating as removing a procedure may leave none
+ * to another it called
+ */
+void Inliner::removeProcedures() {
+    std::vector<bool> kept(routines.size(), true);
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+        std::vector<uint32_t> counts(routines.size(), 0);
+        for (uint32_t i = 0; i < routines.size(); i++) {
+            if (!kept[i]) continue;
+
+            for (const Instruction& instruction : routines[i].getInstructions()) {
+                auto it = indices.find(instruction.getArg2().getValue());
+                if (instruction.getOp() == Opcode::CALL && it != indices.end()) counts[it->second]++;
+            }
+        }
+
+        for (uint32_t i = 0; i < routines.size(); i++) {
+            if (kept[i] && inlined[i] && counts[i] == 0) {
+                kept[i] = false;
+                changed = true;
+                removedCount++;
+            }
+        }
+    }
+
+    std::vector<Routine> remaining;
+    for (uint32_t i = 0; i < routines.size(); i++) {
+        if (kept[i]) remaining.push_back(std::move(routines[i]));
+    }
+    routines.swap(remaining);
+}
+
+/**
+ * Getter for number of calls inlined
+ * @return number of calls replaced by the body of the procedure called
+ */
+uint32_t Inliner::getInlinedCount() const {
+    return inlinedCount;
+}
+
+/**
+ * Getter for number of procedures removed
+ * @return number of procedures removed after their calls were all inlined
+ */
+uint32_t Inliner::getRemovedCount() const {
+    return removedCount;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "Routine.h"
+
+/**
+ * Inlines calls to small procedures, and to procedures called from a single place, replacing the parameters
+ * pushed, the call and the parameters popped with a copy of the procedure's body. The copy assigns the arguments
+ * to its parameters, uses new temporaries in place of the procedure's temporaries and variables, and new labels
+ * in place of its labels, and assigns the value returned to the call's result before jumping past the copy.
+ * Callees are inlined into their callers first, so that nested calls are inlined all the way down. Recursive
+ * procedures, and procedures whose variables are used by procedures declared inside them, are never inlined.
+ * Procedures whose calls were all inlined are removed
+ */
+class Inliner {
+public:
+    //Largest body (in instructions) of a procedure inlined wherever it is called
+    static constexpr uint32_t SIZE_LIMIT = 12;
+
+private:
+    //Program owning the tables of operands, which new temporaries and labels are added to
+    Program& program;
+
+    //Routines of program, the main program first
+    std::vector<Routine>& routines;
+
+    //Index of the routine of each procedure, by label
+    std::unordered_map<uint32_t, uint32_t> indices;
+
+    //Routines called by each routine, by index
+    std::vector<std::vector<uint32_t>> callees;
+
+    //Number of calls to each routine, before inlining
+    std::vector<uint32_t> callCounts;
+
+    //Whether each routine can be inlined
+    std::vector<bool> inlinable;
+
+    //Whether any call to each routine was inlined
+    std::vector<bool> inlined;
+
+    //Label of the procedure declaring each variable (Instruction::NO_LABEL for the main program)
+    std::vector<uint32_t> owners;
+
+    //Number of calls inlined
+    uint32_t inlinedCount;
+
+    //Number of procedures removed
+    uint32_t removedCount;
+
+    //Finds the routines called by each routine, and the number of calls to each
+    void findCalls();
+
+    //Finds the routines which can be inlined: those which cannot call themselves and keep their variables to themselves
+    void findInlinable(const std::vector<bool>& nonLocal);
+
+    //Gets the routines in postorder of calls, so that each comes after those it calls
+    std::vector<uint32_t> getPostorder() const;
+
+    //Inlines the calls of a routine worth inlining
+    void inlineCalls(uint32_t caller);
+
+    //Appends a copy of a procedure's body, replacing a call to it
+    void expand(const Routine& callee, const std::vector<Operand>& arguments, const Operand& result,
+                std::vector<Instruction>& rewritten, std::vector<bool>& removed);
+
+    //Removes procedures whose calls were all inlined
+    void removeProcedures();
+public:
+    //Inlines calls between the routines of a program
+    Inliner(Program& program, std::vector<Routine>& routines);
+
+    //Getter for number of calls inlined
+    uint32_t getInlinedCount() const;
+
+    //Getter for number of procedures removed
+    uint32_t getRemovedCount() const;
+};
@@ -0,0 +1,125 @@
+#include "Liveness.h"
+
+/**
+ * Finds the temporaries and local variables live on entry to and exit from each reachable block,
+ * from the uses before any assignment in each block and those each block assigns,
+ * iterating backwards over the blocks until no set changes
+ * @param routine - to analyse
+ * @param graph - of routine
+ * @param nonLocal - whether each variable of the program is used by a routine other than the one declaring it
+ * @param removed - whether each instruction is to be ignored
+ */
+Liveness::Liveness(const Routine &routine, const ControlFlowGraph &graph, const std::vector<bool> &nonLocal,
+                   const std::vector<bool> &removed) {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+
+    for (const Instruction& instruction : instructions) {
+        for (const Operand* operand : {&instruction.getArg1(), &instruction.getArg2(), &instruction.getResult()}) {
+            bool tracked = operand->getKind() == OperandKind::TEMP
+                           || (operand->getKind() == OperandKind::VARIABLE && !nonLocal[operand->getValue()]);
+            if (tracked && indices.emplace(operand->getStorageKey(), storages.size()).second) {
+                storages.push_back(operand->withVersion(0));
+            }
+        }
+    }
+
+    words = (storages.size() + 63) / 64;
+    uint32_t blocks = graph.getBlockCount();
+    std::vector<uint64_t> used(blocks * words, 0);
+    std::vector<uint64_t> killed(blocks * words, 0);
+    liveIn.assign(blocks * words, 0);
+    liveOut.assign(blocks * words, 0);
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (removed[i]) continue;
+
+            for (const Operand* use : {&instructions[i].getArg1(), &instructions[i].getArg2()}) {
+                uint32_t index = getIndex(*use);
+                if (index != UINT32_MAX && !contains(&killed[block * words], index)) insert(&used[block * words], index);
+            }
+
+            uint32_t index = getIndex(instructions[i].getResult());
+            if (index != UINT32_MAX) insert(&killed[block * words], index);
+        }
+    }
+
+    const std::vector<uint32_t>& order = graph.getReversePostorder();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (auto it = order.rbegin(); it != order.rend(); it++) {
+            uint32_t block = *it;
+
+            for (uint32_t word = 0; word < words; word++) {
+                uint64_t out = 0;
+                for (uint32_t successor : graph.getSuccessors(block)) {
+                    if (successor != ControlFlowGraph::NO_BLOCK) out |= liveIn[successor * words + word];
+                }
+                liveOut[block * words + word] = out;
+
+                uint64_t in = used[block * words + word] | (out & ~killed[block * words + word]);
+                if (in != liveIn[block * words + word]) {
+                    liveIn[block * words + word] = in;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Gets the index of a temporary or variable
+ * @param operand - to get index of
+ * @return index, or UINT32_MAX if operand is not a temporary or local variable
+ */
+uint32_t Liveness::getIndex(const Operand &operand) const {
+    if (!operand.isStorage()) return UINT32_MAX;
+
+    auto it = indices.find(operand.getStorageKey());
+    return (it == indices.end()) ? UINT32_MAX : it->second;
+}
+
+/**
+ * Getter for temporary or variable of an index
+ * @param index - of temporary or variable
+ * @return operand
+ */
+const Operand &Liveness::getStorage(uint32_t index) const {
+    return storages[index];
+}
+
+/**
+ * Getter for number of temporaries and variables tracked
+ * @return number tracked
+ */
+uint32_t Liveness::getCount() const {
+    return storages.size();
+}
+
+/**
+ * Getter for number of words in each set
+ * @return number of 64 bit words
+ */
+uint32_t Liveness::getWords() const {
+    return words;
+}
+
+/**
+ * Getter for set live on entry to a block
+ * @param block - number of block
+ * @return first word of set
+ */
+const uint64_t *Liveness::getLiveIn(uint32_t block) const {
+    return liveIn.data() + block * words;
+}
+
+/**
+ * Getter for set live on exit from a block
+ * @param block - number of block
+ * @return first word of set
+ */
+const uint64_t *Liveness::getLiveOut(uint32_t block) const {
+    return liveOut.data() + block * words;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "ControlFlowGraph.h"
+
+/**
+ * Temporaries and local variables live on entry to and exit from each block of a routine,
+ * stored as a set of bits for each block. Variables used by other routines are not tracked,
+ * as calls may read them wherever they are made
+ */
+class Liveness {
+private:
+    //Index of each temporary and local variable tracked, by storage key
+    std::unordered_map<uint64_t, uint32_t> indices;
+
+    //Temporary or variable of each index
+    std::vector<Operand> storages;
+
+    //Number of 64 bit words in each set
+    uint32_t words;
+
+    //Sets live on entry to each block
+    std::vector<uint64_t> liveIn;
+
+    //Sets live on exit from each block
+    std::vector<uint64_t> liveOut;
+public:
+    //Finds the temporaries and local variables live on entry to and exit from each block
+    Liveness(const Routine& routine, const ControlFlowGraph& graph, const std::vector<bool>& nonLocal,
+             const std::vector<bool>& removed);
+
+    //Gets the index of a temporary or variable (UINT32_MAX if not tracked)
+    uint32_t getIndex(const Operand& operand) const;
+
+    //Getter for temporary or variable of an index
+    const Operand &getStorage(uint32_t index) const;
+
+    //Getter for number of temporaries and variables tracked
+    uint32_t getCount() const;
+
+    //Getter for number of words in each set
+    uint32_t getWords() const;
+
+    //Getter for set live on entry to a block
+    const uint64_t *getLiveIn(uint32_t block) const;
+
+    //Getter for set live on exit from a block
+    const uint64_t *getLiveOut(uint32_t block) const;
+
+    //Returns whether a set contains an index
+    static bool contains(const uint64_t* set, uint32_t index) {
+        return (set[index / 64] >> (index % 64)) & 1;
+    }
+
+    //Adds an index to a set
+    static void insert(uint64_t* set, uint32_t index) {
+        set[index / 64] |= uint64_t(1) << (index % 64);
+    }
+
+    //Removes an index from a set
+    static void erase(uint64_t* set, uint32_t index) {
+        set[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+};
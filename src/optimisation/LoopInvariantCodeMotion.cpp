@@ -0,0 +1,119 @@
+#include "LoopInvariantCodeMotion.h"
+
+/**
+ * Moves loop invariant operations of a routine in static single assignment form out of loops
+ * @param form - of routine, rewritten in place (its preheaders inserted beforehand)
+ */
+LoopInvariantCodeMotion::LoopInvariantCodeMotion(SSAForm &form) : form(form), loops(form), hoistedCount(0) {
+    if (loops.getCount() == 0) return;
+
+    findDefinitions();
+    hoist();
+}
+
+/**
+ * Finds the block defining each version, by phi function or instruction, and the versions used by instructions
+ */
+void LoopInvariantCodeMotion::findDefinitions() {
+    const ControlFlowGraph& graph = form.getGraph();
+    const std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+
+    for (uint32_t block = 0; block < graph.getBlockCount(); block++) {
+        for (const SSAForm::Phi& phi : form.getPhis(block)) {
+            definitions[phi.result.getKey()] = block;
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (form.isRemoved(i)) continue;
+
+            const Operand& result = instructions[i].getResult();
+            if (form.isRenamed(result)) definitions[result.getKey()] = block;
+            used.insert(instructions[i].getArg1().getKey());
+            used.insert(instructions[i].getArg2().getKey());
+        }
+    }
+}
+
+/**
+ * Returns whether an operand has the same value on every iteration of a loop: immediates, versions defined
+ * outside the loop, and versions on entry to the routine (other than temporaries only assigned by calls)
+ * @param operand - to check
+ * @param loop - operand is used in
+ * @return whether operand is invariant
+ */
+bool LoopInvariantCodeMotion::isInvariant(const Operand &operand, uint32_t loop) const {
+    if (operand.empty() || operand.isImmediate()) return true;
+    if (!form.isRenamed(operand)) return false;
+
+    auto it = definitions.find(operand.getKey());
+    if (it == definitions.end()) return operand.getVersion() == 0 && operand.getKind() != OperandKind::TEMP;
+
+    return !loops.contains(loop, it->second);
+}
+
+/**
+ * Returns whether an instruction can run before its loop, regardless of whether it would have, and is worth
+ * moving: operations defining a version used by an instruction, other than divisions which could fail
+ * (by zero, or of the smallest integer by -1)
+ * @param instruction - to check
+ * @return whether instruction can be moved
+ */
+bool LoopInvariantCodeMotion::canHoist(const Instruction &instruction) const {
+    if (!Opcodes::isOperation(instruction.getOp()) || !form.isRenamed(instruction.getResult())
+        || !used.count(instruction.getResult().getKey())) return false;
+    return !instruction.mayFail();
+}
+
+/**
+ * Moves each invariant instruction to the preheader of the outermost loop it is invariant in, visiting blocks
+ * in reverse postorder so that instructions are moved after those defining their arguments
+ */
+void LoopInvariantCodeMotion::hoist() {
+    const ControlFlowGraph& graph = form.getGraph();
+    const std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+    std::vector<std::vector<Instruction>> inserted(graph.getBlockCount());
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        if (loops.getInnermost(block) == Loops::NO_LOOP) continue;
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            const Instruction& instruction = instructions[i];
+            if (form.isRemoved(i) || !canHoist(instruction)) continue;
+
+            //Loops containing a loop the instruction is not invariant in are not either
+            uint32_t target = Loops::NO_LOOP;
+            for (uint32_t loop = loops.getInnermost(block); loop != Loops::NO_LOOP; loop = loops.getLoop(loop).parent) {
+                if (!isInvariant(instruction.getArg1(), loop) || !isInvariant(instruction.getArg2(), loop)) break;
+                if (loops.getLoop(loop).preheader != ControlFlowGraph::NO_BLOCK) target = loop;
+            }
+            if (target == Loops::NO_LOOP) continue;
+
+            Instruction moved = instruction;
+            moved.setLabel(Instruction::NO_LABEL);
+            uint32_t preheader = loops.getLoop(target).preheader;
+            inserted[preheader].push_back(moved);
+            definitions[instruction.getResult().getKey()] = preheader;
+
+            form.remove(i);
+            hoistedCount++;
+        }
+    }
+
+    if (hoistedCount > 0) form.insert(inserted);
+}
+
+/**
+ * Getter for number of instructions moved
+ * @return number of instructions moved out of loops
+ */
+uint32_t LoopInvariantCodeMotion::getHoistedCount() const {
+    return hoistedCount;
+}
+
+/**
+ * Getter for number of loops found
+ * @return number of loops
+ */
+uint32_t LoopInvariantCodeMotion::getLoopCount() const {
+    return loops.getCount();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include "Loops.h"
+
+/**
+ * Loop invariant code motion over a routine in static single assignment form. Operations inside a loop whose
+ * arguments are all defined outside it (or are hoisted themselves) compute the same value on every iteration,
+ * so are moved to the preheader of the outermost loop they are invariant in, the block which control enters the
+ * loop from. Operations only used by phi functions stay, as a copy would be left in their place. Calls are never
+ * moved, as they may print or change variables used by other routines, and those variables are never invariant.
+ * Divisions are only moved by immediates which cannot fail, as the loop may not run
+ */
+class LoopInvariantCodeMotion {
+private:
+    //Routine to move instructions of
+    SSAForm& form;
+
+    //Loops of routine
+    Loops loops;
+
+    //Block defining each version, by key (versions on entry are not stored)
+    std::unordered_map<uint64_t, uint32_t> definitions;
+
+    //Versions used by instructions, by key
+    std::unordered_set<uint64_t> used;
+
+    //Number of instructions moved
+    uint32_t hoistedCount;
+
+    //Finds the block defining each version, and the versions used by instructions
+    void findDefinitions();
+
+    //Returns whether an operand has the same value on every iteration of a loop
+    bool isInvariant(const Operand& operand, uint32_t loop) const;
+
+    //Returns whether an instruction can run before its loop, regardless of whether it would have
+    bool canHoist(const Instruction& instruction) const;
+
+    //Moves the invariant instructions of each loop to its preheader
+    void hoist();
+public:
+    //Moves loop invariant operations of a routine in static single assignment form out of loops
+    explicit LoopInvariantCodeMotion(SSAForm& form);
+
+    //Getter for number of instructions moved
+    uint32_t getHoistedCount() const;
+
+    //Getter for number of loops found
+    uint32_t getLoopCount() const;
+};
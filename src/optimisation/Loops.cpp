@@ -0,0 +1,163 @@
+#include "Loops.h"
+
+/**
+ * Finds the natural loop of each block which a block it dominates jumps back to, walking backwards from
+ * each jump back without passing the header. Loops are found in reverse postorder of headers, so each
+ * loop is found after those containing it and marks its blocks over theirs
+ * @param form - of routine
+ */
+Loops::Loops(const SSAForm &form) {
+    const ControlFlowGraph& graph = form.getGraph();
+    const std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+    innermost.assign(graph.getBlockCount(), NO_LOOP);
+
+    for (uint32_t header : graph.getReversePostorder()) {
+        std::vector<uint32_t> stack;
+        for (uint32_t predecessor : graph.getPredecessors(header)) {
+            if (graph.isReachable(predecessor) && graph.dominates(header, predecessor)) stack.push_back(predecessor);
+        }
+        if (stack.empty()) continue;
+
+        uint32_t loop = loops.size();
+        loops.push_back({header, ControlFlowGraph::NO_BLOCK, innermost[header], stack});
+        innermost[header] = loop;
+
+        while (!stack.empty()) {
+            uint32_t block = stack.back();
+            stack.pop_back();
+            if (innermost[block] == loop) continue;
+
+            innermost[block] = loop;
+            for (uint32_t predecessor : graph.getPredecessors(block)) {
+                if (graph.isReachable(predecessor) && innermost[predecessor] != loop) stack.push_back(predecessor);
+            }
+        }
+    }
+
+    //The preheader is the only block entering the loop, which only jumps to the header
+    for (uint32_t loop = 0; loop < loops.size(); loop++) {
+        uint32_t preheader = ControlFlowGraph::NO_BLOCK;
+        uint32_t entries = 0;
+
+        for (uint32_t predecessor : graph.getPredecessors(loops[loop].header)) {
+            if (contains(loop, predecessor)) continue;
+            preheader = predecessor;
+            entries++;
+        }
+        if (entries != 1 || !graph.isReachable(preheader)) continue;
+
+        uint32_t last = graph.getEnd(preheader) - 1;
+        if (graph.getSuccessors(preheader)[1] == ControlFlowGraph::NO_BLOCK
+            && instructions[last].getOp() == Opcode::GOTO && !form.isRemoved(last)) {
+            loops[loop].preheader = preheader;
+        }
+    }
+}
+
+/**
+ * Returns whether a loop contains a block, i.e. the loop is the innermost loop containing the block or encloses it
+ * @param loop - to check
+ * @param block - to find
+ * @return whether block is in loop
+ */
+bool Loops::contains(uint32_t loop, uint32_t block) const {
+    for (uint32_t enclosing = innermost[block]; enclosing != NO_LOOP; enclosing = loops[enclosing].parent) {
+        if (enclosing == loop) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Getter for number of loops
+ * @return number of loops
+ */
+uint32_t Loops::getCount() const {
+    return loops.size();
+}
+
+/**
+ * Getter for a loop
+ * @param loop - number of loop
+ * @return header, preheader, parent and latches of loop
+ */
+const Loops::Loop &Loops::getLoop(uint32_t loop) const {
+    return loops[loop];
+}
+
+/**
+ * Getter for innermost loop containing a block
+ * @param block - to find
+ * @return innermost loop containing block (NO_LOOP if none)
+ */
+uint32_t Loops::getInnermost(uint32_t block) const {
+    return innermost[block];
+}
+
+/**
+ * Inserts a preheader before each loop header: a jump to the header with a new label, which the jumps entering
+ * the loop are given instead of the header's label, while code falling through to the header falls into it.
+ * Loops where a block falls through back to the header are left as they are
+ * @param program - owning the table of labels
+ * @param routine - to insert preheaders into, before converting it to static single assignment form
+ */
+void Loops::insertPreheaders(Program &program, Routine &routine) {
+    ControlFlowGraph graph(routine);
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    //Label of preheader to insert before each header (Instruction::NO_LABEL if none)
+    std::vector<uint32_t> labels(graph.getBlockCount(), Instruction::NO_LABEL);
+    bool inserted = false;
+
+    for (uint32_t header : graph.getReversePostorder()) {
+        std::vector<uint32_t> entries;
+        bool loop = false;
+        bool branches = true;
+
+        for (uint32_t predecessor : graph.getPredecessors(header)) {
+            if (!graph.isReachable(predecessor) || !graph.dominates(header, predecessor)) {
+                entries.push_back(predecessor);
+                continue;
+            }
+
+            Opcode op = instructions[graph.getEnd(predecessor) - 1].getOp();
+            if (op == Opcode::IFZ) {
+                branches = branches && graph.getSuccessors(predecessor)[0] != header;
+            } else {
+                branches = branches && op == Opcode::GOTO;
+            }
+            loop = true;
+        }
+        if (!loop || !branches) continue;
+
+        Operand label = program.addLabel();
+        Operand target(OperandKind::LABEL, instructions[graph.getBegin(header)].getLabel());
+        labels[header] = label.getValue();
+        inserted = true;
+
+        for (uint32_t entry : entries) {
+            Instruction& jump = instructions[graph.getEnd(entry) - 1];
+            if (jump.getOp() == Opcode::GOTO && jump.getArg1() == target) {
+                jump.setArg1(label);
+            } else if (jump.getOp() == Opcode::IFZ && jump.getResult() == target) {
+                jump.setResult(label);
+            }
+        }
+    }
+    if (!inserted) return;
+
+    std::vector<Instruction> rewritten;
+    rewritten.reserve(instructions.size());
+
+    for (uint32_t block = 0; block < graph.getBlockCount(); block++) {
+        if (labels[block] != Instruction::NO_LABEL) {
+            Operand header(OperandKind::LABEL, instructions[graph.getBegin(block)].getLabel());
+            rewritten.emplace_back(Opcode::GOTO, header, Operand(), Operand());
+            rewritten.back().setLabel(labels[block]);
+        }
+
+        rewritten.insert(rewritten.end(), instructions.begin() + graph.getBegin(block),
+                         instructions.begin() + graph.getEnd(block));
+    }
+
+    instructions.swap(rewritten);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include "SSA.h"
+
+/**
+ * Natural loops of a routine in static single assignment form: for each block which a block it dominates jumps
+ * back to (its header), the blocks which can reach one of those jumps back without passing the header. Loops are
+ * numbered in reverse postorder of headers, so each loop is numbered after those containing it
+ */
+class Loops {
+public:
+    //Loop number used for blocks outside every loop
+    static constexpr uint32_t NO_LOOP = UINT32_MAX;
+
+    //Natural loop of a header
+    struct Loop {
+        //Block which each iteration starts from
+        uint32_t header;
+
+        //Only block outside the loop branching to the header, which only jumps to it (ControlFlowGraph::NO_BLOCK if none)
+        uint32_t preheader;
+
+        //Innermost loop containing this one (NO_LOOP if outermost)
+        uint32_t parent;
+
+        //Blocks in the loop jumping back to the header
+        std::vector<uint32_t> latches;
+    };
+
+private:
+    //Loops of routine, each after those containing it
+    std::vector<Loop> loops;
+
+    //Innermost loop containing each block (NO_LOOP if none)
+    std::vector<uint32_t> innermost;
+public:
+    //Finds the loops of a routine in static single assignment form, with the preheader of each
+    explicit Loops(const SSAForm& form);
+
+    //Getter for number of loops
+    uint32_t getCount() const;
+
+    //Getter for a loop
+    const Loop &getLoop(uint32_t loop) const;
+
+    //Getter for innermost loop containing a block (NO_LOOP if none)
+    uint32_t getInnermost(uint32_t block) const;
+
+    //Returns whether a loop contains a block
+    bool contains(uint32_t loop, uint32_t block) const;
+
+    //Inserts a preheader before each loop header, which code can be moved into
+    static void insertPreheaders(Program& program, Routine& routine);
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+/**
+ * Custom error which is thrown if the three address code
+ * fails a consistency check during optimisation, carrying the message to report
+ */
+class OptimisationException : public std::exception {
+private:
+    std::string errMsg;
+
+public:
+    explicit OptimisationException(std::string msg) : errMsg(std::move(msg))
+    {
+    }
+
+    virtual const char* what() const throw() {
+        return errMsg.c_str();
+    }
+};
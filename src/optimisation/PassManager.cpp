@@ -0,0 +1,444 @@
+#include <chrono>
+#include <iostream>
+#include <unordered_set>
+#include "PassManager.h"
+#include "TailCallElimination.h"
+#include "Inliner.h"
+#include "ConstantPropagation.h"
+#include "ValueNumbering.h"
+#include "CopyPropagation.h"
+#include "LoopInvariantCodeMotion.h"
+#include "InductionVariables.h"
+#include "Loops.h"
+#include "Coalescing.h"
+#include "Peephole.h"
+#include "DeadCodeElimination.h"
+#include "OptimisationException.h"
+
+using std::cout;
+using std::endl;
+
+//Clock used to time each pass
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Splits a program into routines to optimise, registering the passes of the compiler
+ * @param program - to optimise, whose instructions are replaced once the routines are rejoined
+ */
+PassManager::PassManager(Program &program)
+    : program(program), routines(Routine::split(program)), verifyEach(false), initialCount(program.getInstructions().size()) {
+    registerPasses();
+}
+
+/**
+ * Registers the passes of the compiler, each running over every routine (or over the whole program)
+ */
+void PassManager::registerPasses() {
+    registerPass({"tail-calls", "Tail call elimination", "calls replaced with jumps", Stage::ROUTINES, false, [this]() {
+        uint32_t count = 0;
+        nonLocal = SSAForm::findNonLocalVariables(program, routines);
+        for (Routine& routine : routines) {
+            count += TailCallElimination(program, routine, nonLocal).getEliminatedCount();
+        }
+        return count;
+    }});
+    registerPass({"inline", "Inlining", "calls inlined", Stage::ROUTINES, false, [this]() {
+        return Inliner(program, routines).getInlinedCount();
+    }});
+    registerPass({"constants", "Constant propagation", "instructions removed and branches folded", Stage::SSA, false, [this]() {
+        uint32_t count = 0;
+        for (SSAForm& form : forms) {
+            ConstantPropagation propagation(form);
+            count += propagation.getRemovedCount() + propagation.getBranchCount();
+        }
+        return count;
+    }});
+    for (Numbering numbering : {Numbering::GLOBAL, Numbering::LOCAL}) {
+        bool global = numbering == Numbering::GLOBAL;
+        registerPass({global ? "gvn" : "lvn", global ? "Value numbering" : "Local value numbering",
+                      "redundant computations removed", Stage::SSA, false, [this, numbering]() {
+            uint32_t count = 0;
+            for (SSAForm& form : forms) {
+                count += ValueNumbering(form, numbering).getRemovedCount();
+            }
+            return count;
+        }});
+    }
+    registerPass({"copies", "Copy propagation", "copies removed", Stage::SSA, false, [this]() {
+        uint32_t count = 0;
+        for (SSAForm& form : forms) {
+            count += CopyPropagation(form).getRemovedCount();
+        }
+        return count;
+    }});
+    registerPass({"licm", "Loop invariant code motion", "instructions moved out of loops", Stage::SSA, true, [this]() {
+        uint32_t count = 0;
+        for (SSAForm& form : forms) {
+            count += LoopInvariantCodeMotion(form).getHoistedCount();
+        }
+        return count;
+    }});
+    registerPass({"induction", "Strength reduction", "multiplications and induction variables removed", Stage::SSA, true,
+                  [this]() {
+        uint32_t count = 0;
+        for (SSAForm& form : forms) {
+            InductionVariables variables(program, form);
+            count += variables.getReducedCount() + variables.getEliminatedCount();
+        }
+        return count;
+    }});
+    registerPass({"coalesce", "Coalescing", "copies removed", Stage::DESTRUCTED, false, [this]() {
+        uint32_t count = 0;
+        for (Routine& routine : routines) {
+            count += Coalescing(routine, nonLocal).getRemovedCount();
+        }
+        return count;
+    }});
+    registerPass({"peephole", "Peephole optimisation", "sequences rewritten", Stage::DESTRUCTED, false, [this]() {
+        uint32_t count = 0;
+        for (Routine& routine : routines) {
+            count += Peephole(routine).getRewriteCount();
+        }
+        return count;
+    }});
+    registerPass({"dce", "Dead code elimination", "dead instructions removed", Stage::DESTRUCTED, false, [this]() {
+        uint32_t count = 0;
+        for (Routine& routine : routines) {
+            count += DeadCodeElimination(routine, nonLocal).getRemovedCount();
+        }
+        return count;
+    }});
+}
+
+/**
+ * Registers a pass, which can then be named in a pipeline
+ * @param pass - to register (replacing any registered under the same name)
+ */
+void PassManager::registerPass(Pass pass) {
+    uint32_t index = findPass(pass.name);
+    if (index != UINT32_MAX) {
+        passes[index] = std::move(pass);
+        return;
+    }
+
+    passes.push_back(std::move(pass));
+    statistics.emplace_back();
+}
+
+/**
+ * Finds the index of a pass by name
+ * @param name - of pass
+ * @return index of pass, or UINT32_MAX if none is registered under name
+ */
+uint32_t PassManager::findPass(const std::string &name) const {
+    for (uint32_t i = 0; i < passes.size(); i++) {
+        if (passes[i].name == name) return i;
+    }
+
+    return UINT32_MAX;
+}
+
+/**
+ * Sets the pipeline of passes to run from their names, separated by commas, with passes to repeat until
+ * none changes anything in square brackets. Passes must be given in stage order, and a repeated group
+ * must be in a single stage
+ * @param names - of passes, e.g. "inline,[constants,gvn,copies],dce" (empty to run none)
+ */
+void PassManager::setPipeline(const std::string &names) {
+    pipeline.clear();
+    Stage last = Stage::ROUTINES;
+    std::string previous;
+    bool grouped = false;
+    std::string name;
+
+    for (unsigned long i = 0; i <= names.size(); i++) {
+        char c = (i < names.size()) ? names[i] : ',';
+
+        if (c == '[') {
+            if (grouped || !name.empty()) throw OptimisationException("Unexpected '[' in pipeline: " + names);
+            grouped = true;
+            pipeline.push_back({{}, true});
+            continue;
+        }
+        if (c != ',' && c != ']') {
+            name += c;
+            continue;
+        }
+
+        if (!name.empty()) {
+            uint32_t index = findPass(name);
+            if (index == UINT32_MAX) throw OptimisationException("Unknown optimisation pass: " + name);
+            if (passes[index].stage < last) {
+                throw OptimisationException("Optimisation pass " + name + " cannot run after " + previous);
+            }
+
+            //A repeated group runs in a single stage
+            if (grouped && !pipeline.back().passes.empty() && passes[index].stage != last) {
+                throw OptimisationException("Optimisation pass " + name + " runs in a different stage to its group");
+            }
+            if (!grouped) pipeline.push_back({{}, false});
+
+            pipeline.back().passes.push_back(index);
+            last = passes[index].stage;
+            previous = name;
+            name.clear();
+        }
+
+        if (c == ']') {
+            if (!grouped) throw OptimisationException("Unexpected ']' in pipeline: " + names);
+            grouped = false;
+        }
+    }
+
+    if (grouped) throw OptimisationException("Unclosed '[' in pipeline: " + names);
+}
+
+/**
+ * Setter for whether to check the routines after every pass
+ * @param verifyEach - whether to check the consistency of the routines (or their SSA form) after each pass
+ */
+void PassManager::setVerifyEach(bool verifyEach) {
+    this->verifyEach = verifyEach;
+}
+
+/**
+ * Returns whether the pipeline runs any pass
+ * @return whether pipeline is empty
+ */
+bool PassManager::isEmpty() const {
+    for (const Step& step : pipeline) {
+        if (!step.passes.empty()) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Gets the number of instructions of the routines in the current stage, not counting those removed from
+ * static single assignment form (or phi functions)
+ * @param stage - of pipeline
+ * @return number of instructions
+ */
+uint32_t PassManager::countInstructions(Stage stage) const {
+    uint32_t count = 0;
+
+    if (stage == Stage::SSA) {
+        for (const SSAForm& form : forms) {
+            count += form.getInstructionCount();
+        }
+    } else {
+        for (const Routine& routine : routines) {
+            count += routine.getInstructions().size();
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Runs the steps of the pipeline in a stage, repeating each bracketed group until none of its passes changes
+ * anything (or it has run MAX_ITERATIONS times)
+ * @param stage - of pipeline
+ */
+void PassManager::runStage(Stage stage) {
+    for (const Step& step : pipeline) {
+        if (step.passes.empty() || passes[step.passes[0]].stage != stage) continue;
+
+        for (uint32_t iteration = 0; iteration < (step.repeat ? MAX_ITERATIONS : 1); iteration++) {
+            uint32_t changes = 0;
+            for (uint32_t index : step.passes) {
+                changes += runPass(index);
+            }
+            if (changes == 0) break;
+        }
+    }
+}
+
+/**
+ * Runs a pass once, recording its statistics and checking the routines afterwards if verifying each pass
+ * @param index - of pass
+ * @return number of changes made
+ */
+uint32_t PassManager::runPass(uint32_t index) {
+    const Pass& pass = passes[index];
+    Statistics& current = statistics[index];
+    uint32_t before = countInstructions(pass.stage);
+
+    Clock::time_point start = Clock::now();
+    uint32_t changes = pass.run();
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+    uint32_t after = countInstructions(pass.stage);
+    current.runs++;
+    current.changes += changes;
+    current.milliseconds += elapsed.count();
+    current.change += int64_t(after) - int64_t(before);
+    recordTime(pass.title, elapsed.count());
+
+    if (verifyEach) verify(pass);
+    return changes;
+}
+
+/**
+ * Records the time taken by a phase, adding it to the time already taken if it has run before
+ * @param phase - name of phase
+ * @param milliseconds - time taken
+ */
+void PassManager::recordTime(const std::string &phase, double milliseconds) {
+    for (std::pair<std::string, double>& time : times) {
+        if (time.first != phase) continue;
+
+        time.second += milliseconds;
+        return;
+    }
+
+    times.emplace_back(phase, milliseconds);
+}
+
+/**
+ * Checks the static single assignment form of each routine after a pass in that stage, and otherwise that each
+ * routine starts with BeginProg/BeginFunc, ends with EndProg/EndFunc and only jumps to its own labels
+ * @param pass - which has just run
+ */
+void PassManager::verify(const Pass &pass) const {
+    if (pass.stage == Stage::SSA) {
+        try {
+            for (const SSAForm& form : forms) {
+                form.verify();
+            }
+        } catch (OptimisationException& e) {
+            throw OptimisationException("After " + pass.name + ": " + e.what());
+        }
+        return;
+    }
+
+    for (const Routine& routine : routines) {
+        const std::vector<Instruction>& instructions = routine.getInstructions();
+        std::string context = "After " + pass.name + ": routine " + routine.getName(program);
+
+        Opcode begin = routine.isProgram() ? Opcode::BEGIN_PROG : Opcode::BEGIN_FUNC;
+        Opcode end = routine.isProgram() ? Opcode::END_PROG : Opcode::END_FUNC;
+        if (instructions.size() < 2 || instructions.front().getOp() != begin || instructions.back().getOp() != end) {
+            throw OptimisationException(context + " does not start and end as a routine");
+        }
+
+        std::unordered_set<uint32_t> labels;
+        for (const Instruction& instruction : instructions) {
+            if (instruction.hasLabel()) labels.insert(instruction.getLabel());
+        }
+        for (const Instruction& instruction : instructions) {
+            const Operand* target = (instruction.getOp() == Opcode::GOTO) ? &instruction.getArg1()
+                                  : (instruction.getOp() == Opcode::IFZ) ? &instruction.getResult() : nullptr;
+            if (target != nullptr && !labels.count(target->getValue())) {
+                throw OptimisationException(context + " jumps to missing label "
+                                            + program.getLabelName(target->getValue()));
+            }
+        }
+    }
+}
+
+/**
+ * Runs the passes before static single assignment form, converts the routines into it (giving each loop a
+ * preheader first if a pass needs one), then runs the passes in static single assignment form
+ */
+void PassManager::runBeforeDestruction() {
+    runStage(Stage::ROUTINES);
+
+    bool loops = false;
+    for (const Step& step : pipeline) {
+        for (uint32_t index : step.passes) {
+            loops = loops || passes[index].loops;
+        }
+    }
+
+    Clock::time_point start = Clock::now();
+    nonLocal = SSAForm::findNonLocalVariables(program, routines);
+    if (loops) {
+        for (Routine& routine : routines) {
+            Loops::insertPreheaders(program, routine);
+        }
+    }
+    forms.reserve(routines.size());
+    for (Routine& routine : routines) {
+        forms.emplace_back(program, routine, nonLocal);
+    }
+    recordTime("SSA construction", std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+    runStage(Stage::SSA);
+}
+
+/**
+ * Converts the routines out of static single assignment form, runs the passes after it,
+ * and replaces the instructions of the program with those of the routines
+ */
+void PassManager::runAfterDestruction() {
+    Clock::time_point start = Clock::now();
+    for (SSAForm& form : forms) {
+        form.destruct();
+    }
+    forms.clear();
+    recordTime("SSA destruction", std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+    runStage(Stage::DESTRUCTED);
+    Routine::join(program, routines);
+}
+
+/**
+ * Getter for static single assignment form of each routine
+ * @return forms, in order of routines (empty once destructed)
+ */
+const std::vector<SSAForm> &PassManager::getForms() const {
+    return forms;
+}
+
+/**
+ * Getter for time taken by each phase of the pipeline
+ * @return name and time in milliseconds of each phase, in the order they first ran
+ */
+const std::vector<std::pair<std::string, double>> &PassManager::getTimes() const {
+    return times;
+}
+
+/**
+ * Prints the statistics of each pass in the pipeline, in order of first run: the changes it made and the
+ * net change in the number of instructions, followed by the number of instructions before and after optimisation
+ */
+void PassManager::printStatistics() const {
+    cout << "Optimisation Passes:" << endl;
+    cout << "------------------------------------------------------------------" << endl;
+
+    std::unordered_set<uint32_t> printed;
+    for (const Step& step : pipeline) {
+        for (uint32_t index : step.passes) {
+            if (!printed.insert(index).second) continue;
+
+            const Statistics& current = statistics[index];
+            cout << passes[index].title << ": " << current.changes << " " << passes[index].changes
+                 << ", net change of " << (current.change > 0 ? "+" : "") << current.change << " instructions over "
+                 << current.runs << (current.runs == 1 ? " run" : " runs") << endl;
+        }
+    }
+
+    cout << "Optimised " << initialCount << " instructions to " << program.getInstructions().size() << endl;
+}
+
+/**
+ * Gets the pipeline of an optimisation level: 0 runs no passes (not even peephole optimisation, as it is the
+ * default and leaves the code as generated), 1 runs those which are cheap and never grow the program, and 2
+ * also inlines, repeats the scalar passes until they stop finding work, and optimises loops
+ * @param level - optimisation level (0 to 2)
+ * @param localNumbering - whether value numbering only reuses values computed in the same block
+ * @return names of passes in pipeline
+ */
+std::string PassManager::getPreset(uint32_t level, bool localNumbering) {
+    std::string numbering = localNumbering ? "lvn" : "gvn";
+
+    switch (level) {
+        case 0:
+            return "";
+        case 1:
+            return "constants," + numbering + ",copies,coalesce,dce,peephole";
+        default:
+            return "tail-calls,inline,[constants," + numbering + ",copies],licm,induction,coalesce,dce,peephole";
+    }
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "SSA.h"
+
+/**
+ * Runs a pipeline of optimisation passes over the routines of a program. Each pass is registered under a name
+ * with the stage of the pipeline it runs in: on the routines before they are converted into static single
+ * assignment form, on their static single assignment form, or on the routines after converting back out of it.
+ * A pipeline is written as names separated by commas, in stage order, where passes in square brackets are
+ * repeated until none of them changes anything (e.g. inline,[constants,gvn,copies],dce). The number of runs,
+ * the changes each pass made, the net change in the number of instructions and the time taken by each are recorded,
+ * and the routines can be checked for consistency after every pass
+ */
+class PassManager {
+public:
+    //Stage of the pipeline a pass runs in
+    enum class Stage : uint8_t {
+        //On the routines, before static single assignment form is constructed
+        ROUTINES,
+        //On the static single assignment form of each routine
+        SSA,
+        //On the routines, after static single assignment form is destructed
+        DESTRUCTED
+    };
+
+    //Optimisation pass which can be named in a pipeline
+    struct Pass {
+        //Name used in pipelines
+        std::string name;
+
+        //Name printed with its statistics
+        std::string title;
+
+        //Description of the changes counted (e.g. "copies removed")
+        std::string changes;
+
+        //Stage pass runs in
+        Stage stage;
+
+        //Whether pass needs each loop to have a preheader
+        bool loops;
+
+        //Runs pass over every routine, returning the number of changes made
+        std::function<uint32_t()> run;
+    };
+
+    //Statistics of a pass, accumulated over each time it runs
+    struct Statistics {
+        //Number of times pass ran
+        uint32_t runs = 0;
+
+        //Number of changes made
+        uint32_t changes = 0;
+
+        //Net change in the number of instructions (a pass which adds as many as it removes changes nothing)
+        int64_t change = 0;
+
+        //Time taken
+        double milliseconds = 0;
+    };
+
+    //Largest number of times a group of passes is repeated
+    static constexpr uint32_t MAX_ITERATIONS = 8;
+
+private:
+    //Group of passes run in turn, repeated until none changes anything if bracketed
+    struct Step {
+        //Indices of passes
+        std::vector<uint32_t> passes;
+
+        //Whether to repeat passes until none changes anything
+        bool repeat;
+    };
+
+    //Program being optimised
+    Program& program;
+
+    //Routines of program, the main program first
+    std::vector<Routine> routines;
+
+    //Whether each variable of the program is used by a routine other than the one declaring it
+    std::vector<bool> nonLocal;
+
+    //Static single assignment form of each routine, while constructed
+    std::vector<SSAForm> forms;
+
+    //Passes registered, by index
+    std::vector<Pass> passes;
+
+    //Statistics of each pass, by index
+    std::vector<Statistics> statistics;
+
+    //Steps of pipeline, in order
+    std::vector<Step> pipeline;
+
+    //Whether to check the routines after every pass
+    bool verifyEach;
+
+    //Number of instructions of program before optimisation
+    uint32_t initialCount;
+
+    //Time taken by each phase of the pipeline (each pass, and the construction and destruction of SSA form)
+    std::vector<std::pair<std::string, double>> times;
+
+    //Registers the passes of the compiler
+    void registerPasses();
+
+    //Finds the index of a pass by name
+    uint32_t findPass(const std::string& name) const;
+
+    //Gets the number of instructions of the routines in the current stage
+    uint32_t countInstructions(Stage stage) const;
+
+    //Runs the steps of pipeline in a stage
+    void runStage(Stage stage);
+
+    //Runs a pass once, recording its statistics
+    uint32_t runPass(uint32_t index);
+
+    //Records the time taken by a phase
+    void recordTime(const std::string& phase, double milliseconds);
+
+    //Checks the routines, or their static single assignment form, after a pass
+    void verify(const Pass& pass) const;
+public:
+    //Splits a program into routines to optimise, registering the passes of the compiler
+    explicit PassManager(Program& program);
+
+    //Registers a pass, which can then be named in a pipeline
+    void registerPass(Pass pass);
+
+    //Sets the pipeline of passes to run from their names
+    void setPipeline(const std::string& names);
+
+    //Setter for whether to check the routines after every pass
+    void setVerifyEach(bool verifyEach);
+
+    //Returns whether the pipeline runs any pass
+    bool isEmpty() const;
+
+    //Runs the passes before and in static single assignment form, leaving the routines in that form
+    void runBeforeDestruction();
+
+    //Converts the routines out of static single assignment form, runs the passes after it, and rejoins the program
+    void runAfterDestruction();
+
+    //Getter for static single assignment form of each routine
+    const std::vector<SSAForm> &getForms() const;
+
+    //Getter for time taken by each phase of the pipeline
+    const std::vector<std::pair<std::string, double>> &getTimes() const;
+
+    //Prints the statistics of each pass in the pipeline
+    void printStatistics() const;
+
+    //Gets the pipeline of an optimisation level (0 to 2)
+    static std::string getPreset(uint32_t level, bool localNumbering);
+};
@@ -0,0 +1,331 @@
+#include "Peephole.h"
+
+/**
+ * Returns whether an instruction assigns a temporary the result of a copy, operation or call
+ * @param instruction - to test
+ * @return whether instruction assigns a temporary
+ */
+static bool assignsTemp(const Instruction& instruction) {
+    Opcode op = instruction.getOp();
+    return (op == Opcode::ASSIGN || op == Opcode::CALL || Opcodes::isOperation(op))
+           && instruction.getResult().getKind() == OperandKind::TEMP;
+}
+
+/**
+ * Returns whether an instruction is a copy
+ * @param instruction - to test
+ * @return whether instruction is an assignment
+ */
+static bool isCopy(const Instruction& instruction) {
+    return instruction.getOp() == Opcode::ASSIGN;
+}
+
+/**
+ * Returns whether an instruction is a negation
+ * @param instruction - to test
+ * @return whether instruction is a not
+ */
+static bool isNot(const Instruction& instruction) {
+    return instruction.getOp() == Opcode::NOT;
+}
+
+/**
+ * Returns whether an instruction is a conditional branch
+ * @param instruction - to test
+ * @return whether instruction is an IfZ
+ */
+static bool isBranch(const Instruction& instruction) {
+    return instruction.getOp() == Opcode::IFZ;
+}
+
+/**
+ * Returns whether an instruction is an unconditional jump
+ * @param instruction - to test
+ * @return whether instruction is a Goto
+ */
+static bool isJump(const Instruction& instruction) {
+    return instruction.getOp() == Opcode::GOTO;
+}
+
+/**
+ * Returns whether an instruction is a conditional branch or unconditional jump
+ * @param instruction - to test
+ * @return whether instruction is an IfZ or Goto
+ */
+static bool isJumpOrBranch(const Instruction& instruction) {
+    return isJump(instruction) || isBranch(instruction);
+}
+
+/**
+ * Returns whether an instruction is a call
+ * @param instruction - to test
+ * @return whether instruction is a call
+ */
+static bool isCall(const Instruction& instruction) {
+    return instruction.getOp() == Opcode::CALL;
+}
+
+/**
+ * Returns whether an instruction pops the parameters of a call
+ * @param instruction - to test
+ * @return whether instruction is a PopParams
+ */
+static bool isPop(const Instruction& instruction) {
+    return instruction.getOp() == Opcode::POP_PARAMS;
+}
+
+const std::vector<Peephole::Rule> Peephole::RULES = {
+    //t = x op y; z = t  =>  z = x op y
+    {"copy forwarding", {assignsTemp, isCopy}, &Peephole::forwardCopy},
+    //t = Call f; PopParams; z = t  =>  z = Call f; PopParams
+    {"call result forwarding", {isCall, isPop, isCopy}, &Peephole::forwardCallResult},
+    //x = x  =>  (nothing)
+    {"self copy", {isCopy}, &Peephole::removeSelfCopy},
+    //t = not x; u = not t  =>  u = x
+    {"double negation", {isNot, isNot}, &Peephole::removeDoubleNegation},
+    //t = not x; IfZ t Goto L1; Goto L2; L1:  =>  IfZ x Goto L2; L1:
+    {"negated branch", {isNot, isBranch, isJump}, &Peephole::invertBranch},
+    //Goto L; L:  =>  L:
+    {"jump to next", {isJumpOrBranch}, &Peephole::removeJumpToNext},
+    //t = Call f; PopParams (with no parameters pushed)  =>  t = Call f
+    {"empty pop", {isCall, isPop}, &Peephole::removeEmptyPop},
+};
+
+/**
+ * Applies the rules to the instructions of a routine at each position in turn, repeating until none applies,
+ * then removes the instructions marked (passing their labels on)
+ * @param routine - to rewrite
+ */
+Peephole::Peephole(Routine &routine) : routine(routine), rewriteCount(0) {
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    removed.assign(instructions.size(), false);
+    for (const Instruction& instruction : instructions) {
+        countUse(instruction.getArg1(), 1);
+        countUse(instruction.getArg2(), 1);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (uint32_t i = 0; i < instructions.size(); i = next(i)) {
+            if (removed[i]) continue;
+
+            for (const Rule& rule : RULES) {
+                //Matches the instructions kept from i, with no label after the first (including those of removed
+                //instructions between them, which pass on to the next instruction kept)
+                std::vector<uint32_t> window;
+                for (uint32_t j = i; window.size() < rule.pattern.size(); j = next(j)) {
+                    if (j >= instructions.size() || !rule.pattern[window.size()](instructions[j])
+                        || (j != i && isLabelled(window.back(), j))) break;
+                    window.push_back(j);
+                }
+
+                if (window.size() == rule.pattern.size() && (this->*rule.rewrite)(window)) {
+                    rewriteCount++;
+                    changed = true;
+                }
+                if (removed[i]) break;
+            }
+        }
+    }
+
+    routine.erase(removed);
+}
+
+/**
+ * Finds the index of the next instruction kept after an index
+ * @param index - of instruction
+ * @return index of next instruction not removed, or the number of instructions if none
+ */
+uint32_t Peephole::next(uint32_t index) const {
+    do {
+        index++;
+    } while (index < removed.size() && removed[index]);
+
+    return index;
+}
+
+/**
+ * Returns whether any instruction after an index, up to and including another, has a label
+ * @param after - index of instruction before those checked
+ * @param last - index of last instruction checked
+ * @return whether there is a label between the two
+ */
+bool Peephole::isLabelled(uint32_t after, uint32_t last) const {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    for (uint32_t i = after + 1; i <= last; i++) {
+        if (instructions[i].hasLabel()) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Returns whether the instruction kept after an index has a label, either its own or that of a removed
+ * instruction before it (which passes on to it)
+ * @param index - of instruction
+ * @param label - to find
+ * @return whether the label is on the next instruction kept
+ */
+bool Peephole::isLabelledNext(uint32_t index, uint32_t label) const {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    for (uint32_t i = index + 1; i < instructions.size() && i <= next(index); i++) {
+        if (instructions[i].getLabel() == label) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Counts a use of an operand if it is a temporary
+ * @param operand - used
+ * @param change - to number of uses (1 when a use is added, -1 when removed)
+ */
+void Peephole::countUse(const Operand &operand, int32_t change) {
+    if (operand.getKind() == OperandKind::TEMP) uses[operand.getValue()] += change;
+}
+
+/**
+ * Returns whether an operand is a temporary used exactly once
+ * @param operand - to check
+ * @return whether operand is a temporary with a single use
+ */
+bool Peephole::isUsedOnce(const Operand &operand) const {
+    if (operand.getKind() != OperandKind::TEMP) return false;
+
+    auto it = uses.find(operand.getValue());
+    return it != uses.end() && it->second == 1;
+}
+
+/**
+ * Assigns the result of an instruction directly to the temporary or variable it is copied to,
+ * where the copy is the only use of the temporary it assigned, removing the copy
+ * @param assignment - index of the instruction assigning a temporary
+ * @param copy - index of the copy
+ * @return whether the copy was removed
+ */
+bool Peephole::forward(uint32_t assignment, uint32_t copy) {
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    const Operand& source = instructions[copy].getArg1().empty() ? instructions[copy].getArg2() : instructions[copy].getArg1();
+    if (!(source == instructions[assignment].getResult()) || !isUsedOnce(source)) return false;
+
+    countUse(source, -1);
+    instructions[assignment].setResult(instructions[copy].getResult());
+    removed[copy] = true;
+    return true;
+}
+
+/**
+ * Assigns the result of an instruction directly to the temporary or variable it is copied to next
+ * @param window - indices of the instruction and the copy
+ * @return whether the copy was removed
+ */
+bool Peephole::forwardCopy(const std::vector<uint32_t> &window) {
+    return forward(window[0], window[1]);
+}
+
+/**
+ * Assigns the result of a call directly to the temporary or variable it is copied to after popping the parameters
+ * @param window - indices of the call, the pop and the copy
+ * @return whether the copy was removed
+ */
+bool Peephole::forwardCallResult(const std::vector<uint32_t> &window) {
+    return forward(window[0], window[2]);
+}
+
+/**
+ * Removes a copy of a temporary or variable to itself
+ * @param window - index of the copy
+ * @return whether the copy was removed
+ */
+bool Peephole::removeSelfCopy(const std::vector<uint32_t> &window) {
+    const Instruction& copy = routine.getInstructions()[window[0]];
+    if (!(copy.getArg1() == copy.getResult())) return false;
+
+    countUse(copy.getArg1(), -1);
+    removed[window[0]] = true;
+    return true;
+}
+
+/**
+ * Replaces the negation of a negated value with a copy of the value, where the second negation is the only use of
+ * the first's result, removing the first
+ * @param window - indices of the two negations
+ * @return whether the negations were replaced
+ */
+bool Peephole::removeDoubleNegation(const std::vector<uint32_t> &window) {
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    const Instruction& first = instructions[window[0]];
+    Instruction& second = instructions[window[1]];
+    if (!(second.getArg2() == first.getResult()) || !isUsedOnce(first.getResult())) return false;
+
+    countUse(first.getResult(), -1);
+    second.setOp(Opcode::ASSIGN);
+    second.setArg1(first.getArg2());
+    second.setArg2(Operand());
+    removed[window[0]] = true;
+    return true;
+}
+
+/**
+ * Branches on a value rather than its negation, where the branch skips a jump: the branch on the value goes to
+ * where the jump went, and execution falls through to where the branch went. Removes the negation (whose result
+ * must only be used by the branch) and the jump
+ * @param window - indices of the negation, the branch and the jump
+ * @return whether the branch was inverted
+ */
+bool Peephole::invertBranch(const std::vector<uint32_t> &window) {
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    const Instruction& negation = instructions[window[0]];
+    Instruction& branch = instructions[window[1]];
+    const Instruction& jump = instructions[window[2]];
+    if (!(branch.getArg1() == negation.getResult()) || !isUsedOnce(negation.getResult())
+        || !isLabelledNext(window[2], branch.getResult().getValue())) {
+        return false;
+    }
+
+    branch.setArg1(negation.getArg2());
+    branch.setResult(jump.getArg1());
+    removed[window[0]] = true;
+    removed[window[2]] = true;
+    return true;
+}
+
+/**
+ * Removes a jump or branch to the instruction after it
+ * @param window - index of the jump or branch
+ * @return whether it was removed
+ */
+bool Peephole::removeJumpToNext(const std::vector<uint32_t> &window) {
+    const Instruction& jump = routine.getInstructions()[window[0]];
+    uint32_t target = isJump(jump) ? jump.getArg1().getValue() : jump.getResult().getValue();
+    if (!isLabelledNext(window[0], target)) return false;
+
+    if (isBranch(jump)) countUse(jump.getArg1(), -1);
+    removed[window[0]] = true;
+    return true;
+}
+
+/**
+ * Removes popping the parameters of a call which pushed none, found from the instruction kept before the call
+ * @param window - indices of the call and the pop
+ * @return whether the pop was removed
+ */
+bool Peephole::removeEmptyPop(const std::vector<uint32_t> &window) {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    uint32_t previous = window[0];
+    while (previous > 0 && removed[--previous]);
+    if (instructions[previous].getOp() == Opcode::PUSH_PARAM) return false;
+
+    removed[window[1]] = true;
+    return true;
+}
+
+/**
+ * Getter for number of rewrites applied
+ * @return number of rewrites
+ */
+uint32_t Peephole::getRewriteCount() const {
+    return rewriteCount;
+}
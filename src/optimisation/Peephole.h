@@ -0,0 +1,89 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "Routine.h"
+
+/**
+ * Rewrites short sequences of instructions in a routine, sliding a window over the instructions kept and
+ * trying each rule of a table in turn until none applies. A rule lists a test for each instruction of the window,
+ * and a rewrite which checks the rest of its conditions before changing the instructions or marking them removed.
+ * Control can only enter a window at its first instruction, as rules never match instructions with a label after
+ * it (or a removed instruction with a label between them). New rules only need a test for each instruction and a rewrite adding a line to the table
+ */
+class Peephole {
+public:
+    //Sequence of instructions to rewrite
+    struct Rule {
+        //Name of rule
+        const char* name;
+
+        //Test for each instruction of the window, in order
+        std::vector<bool (*)(const Instruction&)> pattern;
+
+        //Rewrites the window, given the indices of its instructions, returning false (changing nothing) if its
+        //conditions do not hold
+        bool (Peephole::*rewrite)(const std::vector<uint32_t>& window);
+    };
+
+    //Rules tried at each position, in order
+    static const std::vector<Rule> RULES;
+
+private:
+    //Routine to rewrite
+    Routine& routine;
+
+    //Whether each instruction has been removed
+    std::vector<bool> removed;
+
+    //Number of times each temporary is used by the instructions kept, by number
+    std::unordered_map<uint32_t, uint32_t> uses;
+
+    //Number of rewrites applied
+    uint32_t rewriteCount;
+
+    //Finds the index of the next instruction kept after an index (the size of the routine if none)
+    uint32_t next(uint32_t index) const;
+
+    //Returns whether any instruction after an index, up to and including another, has a label
+    bool isLabelled(uint32_t after, uint32_t last) const;
+
+    //Returns whether the instruction kept after an index has a label, its own or that of a removed instruction
+    bool isLabelledNext(uint32_t index, uint32_t label) const;
+
+    //Counts a use of an operand if it is a temporary, by a change in count
+    void countUse(const Operand& operand, int32_t change);
+
+    //Returns whether an operand is a temporary used exactly once
+    bool isUsedOnce(const Operand& operand) const;
+
+    //Assigns the result of an instruction directly to the temporary or variable it is copied to
+    bool forward(uint32_t assignment, uint32_t copy);
+
+    //Assigns the result of an instruction directly to the temporary or variable it is copied to next
+    bool forwardCopy(const std::vector<uint32_t>& window);
+
+    //Assigns the result of a call directly to the temporary or variable it is copied to after popping the parameters
+    bool forwardCallResult(const std::vector<uint32_t>& window);
+
+    //Removes a copy of a temporary or variable to itself
+    bool removeSelfCopy(const std::vector<uint32_t>& window);
+
+    //Replaces the negation of a negated value with a copy of the value
+    bool removeDoubleNegation(const std::vector<uint32_t>& window);
+
+    //Branches on a value rather than its negation, where the branch skips a jump
+    bool invertBranch(const std::vector<uint32_t>& window);
+
+    //Removes a jump or branch to the instruction after it
+    bool removeJumpToNext(const std::vector<uint32_t>& window);
+
+    //Removes popping the parameters of a call which pushed none
+    bool removeEmptyPop(const std::vector<uint32_t>& window);
+public:
+    //Applies the rules to the instructions of a routine until none applies
+    explicit Peephole(Routine& routine);
+
+    //Getter for number of rewrites applied
+    uint32_t getRewriteCount() const;
+};
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <iostream>
+#include "RegisterAllocation.h"
+
+/**
+ * Allocates the temporaries and local variables of a routine to a register file, finding their live intervals
+ * then assigning each a register, or a stack slot where none is free
+ * @param routine - to allocate temporaries and variables of
+ * @param graph - of routine
+ * @param nonLocal - whether each variable of the program is used by a routine other than the one declaring it
+ * @param registers - number of registers in register file
+ */
+RegisterAllocation::RegisterAllocation(const Routine &routine, const ControlFlowGraph &graph,
+                                       const std::vector<bool> &nonLocal, uint32_t registers)
+    : liveness(routine, graph, nonLocal, std::vector<bool>(routine.getInstructions().size(), false)),
+      registers(registers), slotCount(0), registerCount(0) {
+    intervals.resize(liveness.getCount());
+    locations.resize(liveness.getCount());
+
+    buildIntervals(routine, graph);
+    allocate();
+}
+
+/**
+ * Finds the live interval of each temporary and variable, numbering the instructions of the reachable blocks in
+ * reverse postorder. Each instruction has two positions, reading its arguments at the first and assigning its
+ * result at the second, so that a temporary last used by an instruction can share a register with its result
+ * @param routine - to find live intervals of
+ * @param graph - of routine
+ */
+void RegisterAllocation::buildIntervals(const Routine &routine, const ControlFlowGraph &graph) {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+
+    auto extend = [this](uint32_t index, uint32_t position) {
+        intervals[index].start = std::min(intervals[index].start, position);
+        intervals[index].end = std::max(intervals[index].end, position);
+    };
+
+    //Calls extend for each temporary or variable in a set
+    auto extendAll = [&](const uint64_t* set, uint32_t position) {
+        for (uint32_t word = 0; word < liveness.getWords(); word++) {
+            for (uint64_t bits = set[word]; bits != 0; bits &= bits - 1) {
+                extend(word * 64 + __builtin_ctzll(bits), position);
+            }
+        }
+    };
+
+    uint32_t position = 0;
+    for (uint32_t block : graph.getReversePostorder()) {
+        extendAll(liveness.getLiveIn(block), position);
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            for (const Operand* use : {&instructions[i].getArg1(), &instructions[i].getArg2()}) {
+                uint32_t index = liveness.getIndex(*use);
+                if (index != UINT32_MAX) extend(index, position);
+            }
+
+            uint32_t index = liveness.getIndex(instructions[i].getResult());
+            if (index != UINT32_MAX) extend(index, position + 1);
+            position += 2;
+        }
+
+        //Live on exit overlaps the result of the block's last instruction
+        extendAll(liveness.getLiveOut(block), position);
+    }
+}
+
+/**
+ * Assigns each live interval, in order of start, the lowest numbered free register. Once every register is in
+ * use, whichever of the active intervals and the new one ends last is spilled, as it would hold its register the
+ * longest. The spilled intervals are then given the lowest numbered free stack slot in the same way.
+ * Registers and stack slots are freed when their interval ends
+ */
+void RegisterAllocation::allocate() {
+    std::vector<uint32_t> order;
+    for (uint32_t index = 0; index < intervals.size(); index++) {
+        if (intervals[index].start != UINT32_MAX) order.push_back(index);
+    }
+    std::sort(order.begin(), order.end(), [this](uint32_t first, uint32_t second) {
+        return intervals[first].start != intervals[second].start ? intervals[first].start < intervals[second].start
+                                                                  : first < second;
+    });
+
+    //Intervals holding a register or a stack slot, in order of end
+    std::vector<uint32_t> active;
+    std::vector<uint32_t> stacked;
+    //Whether each register and stack slot is in use
+    std::vector<bool> busyRegisters(registers, false);
+    std::vector<bool> busySlots;
+
+    auto byEnd = [this](uint32_t first, uint32_t second) {
+        return intervals[first].end < intervals[second].end;
+    };
+
+    //Frees the registers or stack slots of intervals ending before a position
+    auto expire = [&](std::vector<uint32_t>& held, std::vector<bool>& busy, uint32_t position) {
+        uint32_t expired = 0;
+        while (expired < held.size() && intervals[held[expired]].end < position) {
+            busy[locations[held[expired]].number] = false;
+            expired++;
+        }
+        held.erase(held.begin(), held.begin() + expired);
+    };
+
+    //Takes the lowest numbered free register or stack slot, adding a stack slot if none is free
+    auto take = [](std::vector<bool>& busy) {
+        uint32_t number = std::find(busy.begin(), busy.end(), false) - busy.begin();
+        if (number == busy.size()) busy.push_back(false);
+        busy[number] = true;
+        return number;
+    };
+
+    for (uint32_t index : order) {
+        expire(active, busyRegisters, intervals[index].start);
+
+        if (active.size() == registers) {
+            if (active.empty() || intervals[active.back()].end <= intervals[index].end) {
+                locations[index].kind = LocationKind::STACK;
+                continue;
+            }
+
+            uint32_t spilled = active.back();
+            active.pop_back();
+            busyRegisters[locations[spilled].number] = false;
+            locations[spilled].kind = LocationKind::STACK;
+        }
+
+        locations[index] = {LocationKind::REGISTER, take(busyRegisters)};
+        registerCount = std::max(registerCount, locations[index].number + 1);
+        active.insert(std::upper_bound(active.begin(), active.end(), index, byEnd), index);
+    }
+
+    //Intervals spilled after they started keep their stack slot from the start, so slots are given out afterwards
+    for (uint32_t index : order) {
+        if (locations[index].kind != LocationKind::STACK) continue;
+
+        expire(stacked, busySlots, intervals[index].start);
+        locations[index].number = take(busySlots);
+        slotCount = std::max(slotCount, uint32_t(busySlots.size()));
+        stacked.insert(std::upper_bound(stacked.begin(), stacked.end(), index, byEnd), index);
+    }
+}
+
+/**
+ * Gets the location of a temporary or variable
+ * @param operand - temporary or variable
+ * @return register or stack slot, or memory if operand is used by other routines or never live
+ */
+RegisterAllocation::Location RegisterAllocation::getLocation(const Operand &operand) const {
+    uint32_t index = liveness.getIndex(operand);
+    return (index == UINT32_MAX) ? Location() : locations[index];
+}
+
+/**
+ * Gets the live interval of a temporary or variable
+ * @param operand - temporary or variable
+ * @return positions it is live between, with start UINT32_MAX if operand is not allocated
+ */
+RegisterAllocation::Interval RegisterAllocation::getInterval(const Operand &operand) const {
+    uint32_t index = liveness.getIndex(operand);
+    return (index == UINT32_MAX) ? Interval() : intervals[index];
+}
+
+/**
+ * Getter for number of stack slots used
+ * @return largest number of stack slots in use at once
+ */
+uint32_t RegisterAllocation::getSlotCount() const {
+    return slotCount;
+}
+
+/**
+ * Getter for number of registers used
+ * @return number of registers used, at most the size of the register file
+ */
+uint32_t RegisterAllocation::getRegisterCount() const {
+    return registerCount;
+}
+
+/**
+ * Gets the number of temporaries and variables spilled to stack slots
+ * @return number spilled
+ */
+uint32_t RegisterAllocation::getSpilledCount() const {
+    return std::count_if(locations.begin(), locations.end(), [](const Location& location) {
+        return location.kind == LocationKind::STACK;
+    });
+}
+
+/**
+ * Prints the location of each temporary and variable of a routine, in order of first appearance,
+ * as a register (r0, r1, ...), a stack slot (s0, s1, ...) or memory
+ * @param program - owning the tables of operands
+ * @param routine - allocated
+ */
+void RegisterAllocation::print(const Program &program, const Routine &routine) const {
+    std::cout << routine.getName(program) << ": " << registerCount << " registers, " << slotCount
+              << " stack slots, " << getSpilledCount() << " spilled" << std::endl;
+
+    for (uint32_t index = 0; index < locations.size(); index++) {
+        std::string location = (locations[index].kind == LocationKind::REGISTER) ? "r"
+                             : (locations[index].kind == LocationKind::STACK) ? "s" : "";
+        location = location.empty() ? "memory" : location + std::to_string(locations[index].number);
+        std::cout << " " << program.toString(liveness.getStorage(index)) << ": " << location << std::endl;
+    }
+}
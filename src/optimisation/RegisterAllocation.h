@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include "Liveness.h"
+
+/**
+ * Assigns the temporaries and local variables of a routine to registers of a register file with a given number
+ * of registers, or to stack slots where there are not enough (linear scan allocation). The instructions of the
+ * reachable blocks are numbered in reverse postorder, and each temporary or variable is given a live interval
+ * from the first to the last position it is live at. Intervals are visited in order of start, freeing the
+ * registers of those which have ended; when every register is in use, whichever of the active intervals and the
+ * new one ends last is spilled to a stack slot. Variables used by other routines stay in memory. The routine is
+ * left unchanged, so that a backend can choose how to load and store spilled values
+ */
+class RegisterAllocation {
+public:
+    //Where a temporary or variable is kept
+    enum class LocationKind : uint8_t {
+        //In the memory of the variable, as it is used by other routines (or never live)
+        MEMORY,
+        //In a register
+        REGISTER,
+        //In a stack slot of the routine's frame
+        STACK
+    };
+
+    //Location of a temporary or variable, with the number of its register or stack slot
+    struct Location {
+        LocationKind kind = LocationKind::MEMORY;
+        uint32_t number = 0;
+    };
+
+    //Positions a temporary or variable is live between, inclusive (start is UINT32_MAX if never live)
+    struct Interval {
+        uint32_t start = UINT32_MAX;
+        uint32_t end = 0;
+    };
+
+private:
+    //Temporaries and local variables of routine, by index
+    Liveness liveness;
+
+    //Number of registers in register file
+    uint32_t registers;
+
+    //Live interval of each temporary or variable, by index
+    std::vector<Interval> intervals;
+
+    //Location of each temporary or variable, by index
+    std::vector<Location> locations;
+
+    //Number of stack slots used
+    uint32_t slotCount;
+
+    //Number of registers used
+    uint32_t registerCount;
+
+    //Finds the live interval of each temporary or variable
+    void buildIntervals(const Routine& routine, const ControlFlowGraph& graph);
+
+    //Assigns each live interval a register or a stack slot
+    void allocate();
+public:
+    //Allocates the temporaries and local variables of a routine to a register file
+    RegisterAllocation(const Routine& routine, const ControlFlowGraph& graph, const std::vector<bool>& nonLocal,
+                       uint32_t registers);
+
+    //Gets the location of a temporary or variable
+    Location getLocation(const Operand& operand) const;
+
+    //Gets the live interval of a temporary or variable
+    Interval getInterval(const Operand& operand) const;
+
+    //Getter for number of stack slots used
+    uint32_t getSlotCount() const;
+
+    //Getter for number of registers used
+    uint32_t getRegisterCount() const;
+
+    //Gets the number of temporaries and variables spilled to stack slots
+    uint32_t getSpilledCount() const;
+
+    //Prints the location of each temporary and variable of a routine
+    void print(const Program& program, const Routine& routine) const;
+};
@@ -0,0 +1,152 @@
+#include <unordered_map>
+#include "Routine.h"
+
+/**
+ * Constructor for Routine
+ * @param label - of procedure (Instruction::NO_LABEL for the main program)
+ */
+Routine::Routine(uint32_t label) : label(label) {}
+
+/**
+ * Getter for label
+ * @return label of procedure
+ */
+uint32_t Routine::getLabel() const {
+    return label;
+}
+
+/**
+ * Returns whether routine is the main program
+ * @return whether routine has no procedure label
+ */
+bool Routine::isProgram() const {
+    return label == Instruction::NO_LABEL;
+}
+
+/**
+ * Getter for instructions
+ * @return instructions of routine
+ */
+std::vector<Instruction> &Routine::getInstructions() {
+    return instructions;
+}
+
+/**
+ * Getter for instructions
+ * @return instructions of routine
+ */
+const std::vector<Instruction> &Routine::getInstructions() const {
+    return instructions;
+}
+
+/**
+ * Removes instructions, passing the label of each on to the next instruction kept so that branches
+ * to it go to the instruction which followed it. Where that instruction has its own label,
+ * branches are redirected to it instead
+ * @param removed - whether to remove each instruction (EndProg/EndFunc is never removed)
+ */
+void Routine::erase(const std::vector<bool> &removed) {
+    std::vector<Instruction> kept;
+    kept.reserve(instructions.size());
+    //Label of a removed instruction, passed on to the next instruction kept
+    uint32_t pending = Instruction::NO_LABEL;
+    //Labels of removed instructions, mapped to the label they were replaced by
+    std::unordered_map<uint32_t, uint32_t> aliases;
+
+    for (unsigned long i = 0; i < instructions.size(); i++) {
+        Instruction instruction = instructions[i];
+
+        if (removed[i]) {
+            if (!instruction.hasLabel()) continue;
+
+            if (pending == Instruction::NO_LABEL) {
+                pending = instruction.getLabel();
+            } else {
+                aliases[instruction.getLabel()] = pending;
+            }
+            continue;
+        }
+
+        if (pending != Instruction::NO_LABEL) {
+            if (instruction.hasLabel()) {
+                aliases[pending] = instruction.getLabel();
+            } else {
+                instruction.setLabel(pending);
+            }
+            pending = Instruction::NO_LABEL;
+        }
+        kept.push_back(instruction);
+    }
+
+    //Follows the labels replaced to the one which remains
+    auto resolve = [&aliases](Operand label) {
+        for (auto it = aliases.find(label.getValue()); it != aliases.end(); it = aliases.find(label.getValue())) {
+            label = Operand(OperandKind::LABEL, it->second);
+        }
+        return label;
+    };
+
+    for (Instruction& instruction : kept) {
+        if (instruction.getOp() == Opcode::GOTO) {
+            instruction.setArg1(resolve(instruction.getArg1()));
+        } else if (instruction.getOp() == Opcode::IFZ) {
+            instruction.setResult(resolve(instruction.getResult()));
+        }
+    }
+
+    instructions.swap(kept);
+}
+
+/**
+ * Gets the name of routine
+ * @param program - storing label names
+ * @return name of procedure, or "program" for the main program
+ */
+std::string Routine::getName(const Program &program) const {
+    return isProgram() ? "program" : program.getLabelName(label);
+}
+
+/**
+ * Splits the instructions of a program into routines. Procedures declared inside
+ * another routine are removed from it, so that each routine is contiguous
+ * @param program - to split
+ * @return routines, the main program first followed by procedures in order of declaration
+ */
+std::vector<Routine> Routine::split(const Program &program) {
+    std::vector<Routine> routines;
+    //Indices of the routines whose instructions are being collected, innermost last
+    std::vector<unsigned long> open;
+
+    for (const Instruction& instruction : program.getInstructions()) {
+        //Begins a new routine
+        if (instruction.getOp() == Opcode::BEGIN_PROG || instruction.getOp() == Opcode::BEGIN_FUNC) {
+            open.push_back(routines.size());
+            routines.emplace_back(instruction.getOp() == Opcode::BEGIN_PROG ? Instruction::NO_LABEL : instruction.getLabel());
+        }
+
+        if (open.empty()) continue;
+
+        routines[open.back()].getInstructions().push_back(instruction);
+
+        //Returns to the enclosing routine
+        if (instruction.getOp() == Opcode::END_PROG || instruction.getOp() == Opcode::END_FUNC) {
+            open.pop_back();
+        }
+    }
+
+    return routines;
+}
+
+/**
+ * Replaces the instructions of a program with those of its routines, each written in turn
+ * @param program - to replace instructions of
+ * @param routines - to write
+ */
+void Routine::join(Program &program, const std::vector<Routine> &routines) {
+    std::vector<Instruction>& instructions = program.getInstructions();
+    instructions.clear();
+
+    for (const Routine& routine : routines) {
+        instructions.insert(instructions.end(), routine.getInstructions().begin(), routine.getInstructions().end());
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include "../tac_generation/Program.h"
+
+/**
+ * Stores the instructions of the main program or of a single procedure,
+ * from its BeginProg/BeginFunc instruction to its EndProg/EndFunc instruction,
+ * without the instructions of any procedures declared inside it
+ */
+class Routine {
+private:
+    //Label of procedure (Instruction::NO_LABEL for the main program)
+    uint32_t label;
+
+    //Instructions of routine, in order
+    std::vector<Instruction> instructions;
+public:
+    //Constructor
+    explicit Routine(uint32_t label);
+
+    //Getter for label
+    uint32_t getLabel() const;
+
+    //Returns whether routine is the main program
+    bool isProgram() const;
+
+    //Getter for instructions
+    std::vector<Instruction> &getInstructions();
+
+    //Getter for instructions
+    const std::vector<Instruction> &getInstructions() const;
+
+    //Removes instructions, passing the label of each on to the next instruction kept
+    void erase(const std::vector<bool>& removed);
+
+    //Gets the name of routine
+    std::string getName(const Program& program) const;
+
+    //Splits the instructions of a program into routines, the main program first followed by procedures in order
+    static std::vector<Routine> split(const Program& program);
+
+    //Replaces the instructions of a program with those of its routines, each written in turn
+    static void join(Program& program, const std::vector<Routine>& routines);
+};
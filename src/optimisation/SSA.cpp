@@ -0,0 +1,834 @@
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+#include "SSA.h"
+#include "OptimisationException.h"
+
+/**
+ * Converts a routine into static single assignment form
+ * @param program - owning the tables of operands
+ * @param routine - to convert in place
+ * @param nonLocal - whether each variable of the program is used by a routine other than the one declaring it
+ */
+SSAForm::SSAForm(Program &program, Routine &routine, const std::vector<bool> &nonLocal)
+        : program(program), routine(routine), graph(routine), nonLocal(nonLocal), phis(graph.getBlockCount()),
+          removed(routine.getInstructions().size(), false) {
+    findFrontiers();
+    placePhis();
+    rename();
+}
+
+/**
+ * Finds the dominance frontier of each reachable block, walking up the dominator tree
+ * from each predecessor of a join point until reaching its immediate dominator
+ */
+void SSAForm::findFrontiers() {
+    frontiers.assign(graph.getBlockCount(), std::vector<uint32_t>());
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        if (graph.getPredecessors(block).size() < 2) continue;
+
+        for (uint32_t predecessor : graph.getPredecessors(block)) {
+            if (!graph.isReachable(predecessor)) continue;
+
+            for (uint32_t runner = predecessor; runner != graph.getImmediateDominator(block);
+                 runner = graph.getImmediateDominator(runner)) {
+                if (frontiers[runner].empty() || frontiers[runner].back() != block) {
+                    frontiers[runner].push_back(block);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Places phi functions for each renamed temporary or variable at the iterated dominance frontier
+ * of the blocks assigning it, wherever it is live on entry to the block
+ */
+void SSAForm::placePhis() {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    //Temporary or variable of each index, and the blocks which assign it or use it before assigning it
+    std::vector<Operand> storages;
+    std::vector<std::vector<uint32_t>> assigned;
+    std::vector<std::vector<uint32_t>> exposed;
+    //Last block (plus one) to assign and to use each temporary or variable
+    std::vector<uint32_t> assignedIn;
+    std::vector<uint32_t> exposedIn;
+
+    //Gets the index of a temporary or variable, adding it if not yet present
+    auto index = [&](const Operand& operand) {
+        auto inserted = indices.emplace(operand.getStorageKey(), storages.size());
+        if (inserted.second) {
+            storages.push_back(operand.withVersion(0));
+            assigned.emplace_back();
+            exposed.emplace_back();
+            assignedIn.push_back(0);
+            exposedIn.push_back(0);
+        }
+        return inserted.first->second;
+    };
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            const Instruction& instruction = instructions[i];
+
+            //Records uses before any assignment in the block
+            for (const Operand* use : {&instruction.getArg1(), &instruction.getArg2()}) {
+                if (!isRenamed(*use)) continue;
+                uint32_t storage = index(*use);
+                if (assignedIn[storage] != block + 1 && exposedIn[storage] != block + 1) {
+                    exposedIn[storage] = block + 1;
+                    exposed[storage].push_back(block);
+                }
+            }
+
+            if (isRenamed(instruction.getResult())) {
+                uint32_t storage = index(instruction.getResult());
+                if (assignedIn[storage] != block + 1) {
+                    assignedIn[storage] = block + 1;
+                    assigned[storage].push_back(block);
+                }
+            }
+        }
+    }
+
+    //Blocks marked for the temporary or variable being placed (with its index plus one)
+    std::vector<uint32_t> live(graph.getBlockCount(), 0);
+    std::vector<uint32_t> defining(graph.getBlockCount(), 0);
+    std::vector<uint32_t> placed(graph.getBlockCount(), 0);
+    std::vector<uint32_t> worklist;
+
+    for (uint32_t storage = 0; storage < storages.size(); storage++) {
+        //Only assigned once in a single block, or never, so versions never meet
+        if (assigned[storage].empty()) continue;
+        uint32_t mark = storage + 1;
+
+        for (uint32_t block : assigned[storage]) {
+            defining[block] = mark;
+        }
+
+        //Finds the blocks it is live on entry to, searching backwards from its uses
+        worklist = exposed[storage];
+        for (uint32_t block : worklist) {
+            live[block] = mark;
+        }
+        while (!worklist.empty()) {
+            uint32_t block = worklist.back();
+            worklist.pop_back();
+
+            for (uint32_t predecessor : graph.getPredecessors(block)) {
+                if (graph.isReachable(predecessor) && live[predecessor] != mark && defining[predecessor] != mark) {
+                    live[predecessor] = mark;
+                    worklist.push_back(predecessor);
+                }
+            }
+        }
+
+        //Places phi functions at the iterated dominance frontier of its assignments
+        worklist = assigned[storage];
+        while (!worklist.empty()) {
+            uint32_t block = worklist.back();
+            worklist.pop_back();
+
+            for (uint32_t frontier : frontiers[block]) {
+                if (placed[frontier] == mark) continue;
+                placed[frontier] = mark;
+
+                //Pruned, as a phi function is only needed where the value is live
+                if (live[frontier] != mark) continue;
+                phis[frontier].push_back({storages[storage],
+                                          std::vector<Operand>(graph.getPredecessors(frontier).size(), storages[storage])});
+
+                //The phi function assigns a new version, which may itself need merging
+                if (defining[frontier] != mark) {
+                    defining[frontier] = mark;
+                    worklist.push_back(frontier);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Renames each use to its reaching version and each assignment to a new version,
+ * walking the dominator tree with a stack of versions for each temporary or variable
+ */
+void SSAForm::rename() {
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    std::vector<std::vector<uint32_t>> stacks(indices.size());
+    std::vector<uint32_t> counters(indices.size(), 0);
+    //Indices of the temporaries and variables assigned along the current path, in order
+    std::vector<uint32_t> assignments;
+
+    //Gets the version of a temporary or variable reaching the current point
+    auto current = [&](const Operand& operand) {
+        const std::vector<uint32_t>& versions = stacks[indices.at(operand.getStorageKey())];
+        return operand.withVersion(versions.empty() ? 0 : versions.back());
+    };
+
+    //Assigns a new version of a temporary or variable
+    auto assign = [&](const Operand& operand) {
+        uint32_t storage = indices.at(operand.getStorageKey());
+        stacks[storage].push_back(++counters[storage]);
+        assignments.push_back(storage);
+        return operand.withVersion(counters[storage]);
+    };
+
+    //Blocks being visited, with the number of their children visited and the assignments made before them
+    struct Frame {
+        uint32_t block;
+        uint32_t child;
+        unsigned long assignments;
+    };
+    std::vector<Frame> frames;
+
+    //Renames the phi functions and instructions of a block, then the phi arguments of its successors
+    auto visit = [&](uint32_t block) {
+        frames.push_back({block, 0, assignments.size()});
+
+        for (Phi& phi : phis[block]) {
+            phi.result = assign(phi.result);
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            Instruction& instruction = instructions[i];
+
+            if (isRenamed(instruction.getArg1())) instruction.setArg1(current(instruction.getArg1()));
+            if (isRenamed(instruction.getArg2())) instruction.setArg2(current(instruction.getArg2()));
+            if (isRenamed(instruction.getResult())) instruction.setResult(assign(instruction.getResult()));
+        }
+
+        for (uint32_t successor : graph.getSuccessors(block)) {
+            if (successor == ControlFlowGraph::NO_BLOCK) continue;
+            uint32_t index = predecessorIndex(block, successor);
+
+            for (Phi& phi : phis[successor]) {
+                phi.arguments[index] = current(phi.arguments[index]);
+            }
+        }
+    };
+
+    visit(graph.getEntry());
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+        BlockRange children = graph.getDominatorChildren(frame.block);
+
+        if (frame.child < children.size()) {
+            visit(children.begin()[frame.child++]);
+        } else {
+            //Restores the versions reaching the block's parent in the dominator tree
+            while (assignments.size() > frame.assignments) {
+                stacks[assignments.back()].pop_back();
+                assignments.pop_back();
+            }
+            frames.pop_back();
+        }
+    }
+}
+
+/**
+ * Gets the position of a block in the predecessors of another
+ * @param block - predecessor
+ * @param successor - block whose predecessors to search
+ * @return index of block in predecessors
+ */
+uint32_t SSAForm::predecessorIndex(uint32_t block, uint32_t successor) const {
+    BlockRange predecessors = graph.getPredecessors(successor);
+    return std::find(predecessors.begin(), predecessors.end(), block) - predecessors.begin();
+}
+
+/**
+ * Getter for routine
+ * @return routine
+ */
+Routine &SSAForm::getRoutine() {
+    return routine;
+}
+
+/**
+ * Getter for routine
+ * @return routine
+ */
+const Routine &SSAForm::getRoutine() const {
+    return routine;
+}
+
+/**
+ * Getter for control flow graph of routine
+ * @return graph
+ */
+const ControlFlowGraph &SSAForm::getGraph() const {
+    return graph;
+}
+
+/**
+ * Getter for phi functions at the start of a block
+ * @param block - number of block
+ * @return phi functions
+ */
+std::vector<SSAForm::Phi> &SSAForm::getPhis(uint32_t block) {
+    return phis[block];
+}
+
+/**
+ * Getter for phi functions at the start of a block
+ * @param block - number of block
+ * @return phi functions
+ */
+const std::vector<SSAForm::Phi> &SSAForm::getPhis(uint32_t block) const {
+    return phis[block];
+}
+
+/**
+ * Gets the number of instructions which have not been removed
+ * @return number of instructions kept
+ */
+uint32_t SSAForm::getInstructionCount() const {
+    return std::count(removed.begin(), removed.end(), false);
+}
+
+/**
+ * Removes an instruction, which stays in place (keeping the blocks of the graph the same)
+ * until it is dropped when converting out of static single assignment form
+ * @param instruction - index of instruction
+ */
+void SSAForm::remove(uint32_t instruction) {
+    removed[instruction] = true;
+}
+
+/**
+ * Returns whether an instruction has been removed
+ * @param instruction - index of instruction
+ * @return whether instruction is removed
+ */
+bool SSAForm::isRemoved(uint32_t instruction) const {
+    return removed[instruction];
+}
+
+/**
+ * Inserts instructions at the end of blocks, before the jump ending each, so that the blocks of the graph
+ * stay the same. The first instruction inserted into a block takes the label of the jump, if it has one
+ * @param inserted - instructions to insert into each block, in order (each block must end with a jump to insert into)
+ */
+void SSAForm::insert(const std::vector<std::vector<Instruction>> &inserted) {
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    std::vector<Instruction> rewritten;
+    std::vector<bool> flags;
+    rewritten.reserve(instructions.size());
+    flags.reserve(instructions.size());
+
+    for (uint32_t block = 0; block < graph.getBlockCount(); block++) {
+        uint32_t last = graph.getEnd(block) - 1;
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (i == last && !inserted[block].empty()) {
+                uint32_t first = rewritten.size();
+                rewritten.insert(rewritten.end(), inserted[block].begin(), inserted[block].end());
+                flags.insert(flags.end(), inserted[block].size(), false);
+
+                rewritten[first].setLabel(instructions[i].getLabel());
+                instructions[i].setLabel(Instruction::NO_LABEL);
+            }
+
+            rewritten.push_back(instructions[i]);
+            flags.push_back(removed[i]);
+        }
+    }
+
+    instructions.swap(rewritten);
+    removed.swap(flags);
+    graph = ControlFlowGraph(routine);
+}
+
+/**
+ * Returns whether an operand is a temporary or variable which is renamed,
+ * i.e. a temporary or a variable only used by the routine declaring it
+ * @param operand - to check
+ * @return whether operand is renamed
+ */
+bool SSAForm::isRenamed(const Operand &operand) const {
+    return operand.getKind() == OperandKind::TEMP
+           || (operand.getKind() == OperandKind::VARIABLE && !nonLocal[operand.getValue()]);
+}
+
+/**
+ * Checks that each version is assigned exactly once, that its assignment dominates each of its uses,
+ * and that each phi function has an argument for each predecessor
+ * @throws OptimisationException - describing the first inconsistency found
+ */
+void SSAForm::verify() const {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    //Block and position of the assignment of each version (phi functions come before the instructions of a block)
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint64_t>> assignments;
+
+    auto fail = [this](const std::string& message) {
+        throw OptimisationException("SSA verification failed in " + routine.getName(program) + ": " + message);
+    };
+
+    auto assign = [&](const Operand& operand, uint32_t block, uint64_t position) {
+        if (operand.getVersion() == 0) {
+            fail(program.toString(operand) + " is assigned without a version");
+        }
+        if (!assignments.emplace(operand.getKey(), std::make_pair(block, position)).second) {
+            fail(program.toString(operand) + " is assigned more than once");
+        }
+    };
+
+    auto use = [&](const Operand& operand, uint32_t block, uint64_t position) {
+        if (operand.isStorage() && !isRenamed(operand) && operand.getVersion() != 0) {
+            fail(program.toString(operand) + " is versioned but is not renamed");
+        }
+        if (!isRenamed(operand) || operand.getVersion() == 0) return;
+
+        auto it = assignments.find(operand.getKey());
+        if (it == assignments.end()) {
+            fail(program.toString(operand) + " is used but never assigned");
+        }
+
+        uint32_t assignedIn = it->second.first;
+        bool dominated = (assignedIn == block) ? it->second.second < position : graph.dominates(assignedIn, block);
+        if (!dominated) {
+            fail(program.toString(operand) + " is used where its assignment does not dominate it");
+        }
+    };
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        for (const Phi& phi : phis[block]) {
+            if (phi.arguments.size() != graph.getPredecessors(block).size()) {
+                fail("phi function for " + program.toString(phi.result) + " has "
+                     + std::to_string(phi.arguments.size()) + " arguments but its block has "
+                     + std::to_string(graph.getPredecessors(block).size()) + " predecessors");
+            }
+            assign(phi.result, block, 2 * uint64_t(graph.getBegin(block)));
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (!removed[i] && isRenamed(instructions[i].getResult())) assign(instructions[i].getResult(), block, 2 * uint64_t(i) + 1);
+        }
+    }
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        for (const Phi& phi : phis[block]) {
+            //Each argument is used at the end of its predecessor
+            for (uint32_t i = 0; i < phi.arguments.size(); i++) {
+                uint32_t predecessor = graph.getPredecessors(block).begin()[i];
+                if (graph.isReachable(predecessor)) {
+                    use(phi.arguments[i], predecessor, 2 * uint64_t(graph.getEnd(predecessor)));
+                }
+            }
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (removed[i]) continue;
+            use(instructions[i].getArg1(), block, 2 * uint64_t(i) + 1);
+            use(instructions[i].getArg2(), block, 2 * uint64_t(i) + 1);
+        }
+    }
+}
+
+/**
+ * Maps each version to the temporary or variable storing it after destruction. Versions of the same
+ * temporary or variable share it unless their lifetimes overlap (e.g. after copies are propagated),
+ * in which case later versions are given new temporaries
+ * @return storage of each version, by key (versions not present are stored in their own temporary or variable)
+ */
+std::unordered_map<uint64_t, Operand> SSAForm::assignStorage() {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    std::unordered_map<uint64_t, Operand> storage;
+
+    //Versions of each renamed temporary or variable, in order first seen
+    std::unordered_map<uint64_t, std::vector<Operand>> versions;
+    std::vector<uint64_t> seenStorage;
+    std::unordered_set<uint64_t> seen;
+
+    auto record = [&](const Operand& operand) {
+        if (!isRenamed(operand) || !seen.insert(operand.getKey()).second) return;
+        std::vector<Operand>& list = versions[operand.getStorageKey()];
+        if (list.empty()) seenStorage.push_back(operand.getStorageKey());
+        list.push_back(operand);
+    };
+
+    for (uint32_t block : graph.getReversePostorder()) {
+        for (const Phi& phi : phis[block]) {
+            record(phi.result);
+            for (const Operand& argument : phi.arguments) record(argument);
+        }
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (removed[i]) continue;
+            record(instructions[i].getArg1());
+            record(instructions[i].getArg2());
+            record(instructions[i].getResult());
+        }
+    }
+
+    //Numbers the versions of temporaries and variables with more than one, keeping each one's versions together
+    std::vector<Operand> names;
+    std::unordered_map<uint64_t, uint32_t> nameIndices;
+    std::vector<std::pair<uint32_t, uint32_t>> groups;
+
+    for (uint64_t key : seenStorage) {
+        std::vector<Operand>& list = versions[key];
+        if (list.size() < 2) continue;
+
+        std::sort(list.begin(), list.end(), [](const Operand& a, const Operand& b) { return a.getVersion() < b.getVersion(); });
+        uint32_t first = names.size();
+        for (const Operand& name : list) {
+            nameIndices[name.getKey()] = names.size();
+            names.push_back(name);
+        }
+        for (unsigned long i = 0; i < list.size(); i++) {
+            groups.emplace_back(first, names.size());
+        }
+    }
+
+    if (names.empty()) return storage;
+
+    //Sets of versions for each block, as bits
+    uint32_t words = (names.size() + 63) / 64;
+    uint32_t blocks = graph.getBlockCount();
+    std::vector<uint64_t> used(blocks * words, 0);
+    std::vector<uint64_t> killed(blocks * words, 0);
+    std::vector<uint64_t> phiUsed(blocks * words, 0);
+    std::vector<uint64_t> liveIn(blocks * words, 0);
+    std::vector<uint64_t> liveOut(blocks * words, 0);
+
+    auto find = [&](const Operand& operand) {
+        if (!isRenamed(operand)) return UINT32_MAX;
+        auto it = nameIndices.find(operand.getKey());
+        return (it == nameIndices.end()) ? UINT32_MAX : it->second;
+    };
+    auto test = [words](const std::vector<uint64_t>& set, uint32_t block, uint32_t name) {
+        return (set[block * words + name / 64] >> (name % 64)) & 1;
+    };
+    auto set = [words](std::vector<uint64_t>& set, uint32_t block, uint32_t name) {
+        set[block * words + name / 64] |= uint64_t(1) << (name % 64);
+    };
+
+    //Finds the versions used before being assigned in each block, and the versions each block assigns
+    for (uint32_t block : graph.getReversePostorder()) {
+        for (const Phi& phi : phis[block]) {
+            uint32_t name = find(phi.result);
+            if (name != UINT32_MAX) set(killed, block, name);
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (removed[i]) continue;
+            for (const Operand* use : {&instructions[i].getArg1(), &instructions[i].getArg2()}) {
+                uint32_t name = find(*use);
+                if (name != UINT32_MAX && !test(killed, block, name)) set(used, block, name);
+            }
+            uint32_t name = find(instructions[i].getResult());
+            if (name != UINT32_MAX) set(killed, block, name);
+        }
+
+        //Arguments of phi functions are used at the end of the predecessor they come from
+        for (uint32_t successor : graph.getSuccessors(block)) {
+            if (successor == ControlFlowGraph::NO_BLOCK) continue;
+            uint32_t index = predecessorIndex(block, successor);
+            for (const Phi& phi : phis[successor]) {
+                uint32_t name = find(phi.arguments[index]);
+                if (name != UINT32_MAX) set(phiUsed, block, name);
+            }
+        }
+    }
+
+    //Finds the versions live on entry to and exit from each block, iterating backwards until none change
+    const std::vector<uint32_t>& order = graph.getReversePostorder();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (auto it = order.rbegin(); it != order.rend(); it++) {
+            uint32_t block = *it;
+
+            for (uint32_t word = 0; word < words; word++) {
+                uint64_t out = phiUsed[block * words + word];
+                for (uint32_t successor : graph.getSuccessors(block)) {
+                    if (successor != ControlFlowGraph::NO_BLOCK) out |= liveIn[successor * words + word];
+                }
+                liveOut[block * words + word] = out;
+
+                uint64_t in = used[block * words + word] | (out & ~killed[block * words + word]);
+                if (in != liveIn[block * words + word]) {
+                    liveIn[block * words + word] = in;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    //Finds the versions which are live where another version of the same temporary or variable is assigned
+    std::unordered_set<uint64_t> overlapping;
+    auto overlap = [&](uint32_t first, uint32_t second) {
+        return overlapping.count((uint64_t(std::min(first, second)) << 32) | std::max(first, second)) != 0;
+    };
+
+    std::vector<uint64_t> live(words);
+    for (uint32_t block : order) {
+        std::copy(liveOut.begin() + block * words, liveOut.begin() + (block + 1) * words, live.begin());
+
+        auto assign = [&](uint32_t name) {
+            for (uint32_t other = groups[name].first; other < groups[name].second; other++) {
+                if (other != name && ((live[other / 64] >> (other % 64)) & 1)) {
+                    overlapping.insert((uint64_t(std::min(name, other)) << 32) | std::max(name, other));
+                }
+            }
+        };
+
+        for (uint32_t i = graph.getEnd(block); i-- > graph.getBegin(block);) {
+            if (removed[i]) continue;
+            uint32_t name = find(instructions[i].getResult());
+            if (name != UINT32_MAX) {
+                assign(name);
+                live[name / 64] &= ~(uint64_t(1) << (name % 64));
+            }
+
+            for (const Operand* use : {&instructions[i].getArg1(), &instructions[i].getArg2()}) {
+                uint32_t used = find(*use);
+                if (used != UINT32_MAX) live[used / 64] |= uint64_t(1) << (used % 64);
+            }
+        }
+
+        for (const Phi& phi : phis[block]) {
+            uint32_t name = find(phi.result);
+            if (name != UINT32_MAX) assign(name);
+        }
+    }
+
+    //Gives each version the first storage which no earlier version sharing it overlaps with, starting from its own
+    std::vector<uint32_t> colours(names.size(), 0);
+    for (uint32_t first = 0; first < names.size(); first = groups[first].second) {
+        std::vector<Operand> palette {names[first].withVersion(0)};
+
+        for (uint32_t name = first; name < groups[first].second; name++) {
+            uint32_t colour = 0;
+            for (; colour < palette.size(); colour++) {
+                bool free = true;
+                for (uint32_t other = first; other < name && free; other++) {
+                    free = colours[other] != colour || !overlap(name, other);
+                }
+                if (free) break;
+            }
+
+            if (colour == palette.size()) palette.push_back(program.addTemp());
+            colours[name] = colour;
+            storage[names[name].getKey()] = palette[colour];
+        }
+    }
+
+    return storage;
+}
+
+/**
+ * Orders a set of copies made in parallel so that no copy overwrites the source of a later one,
+ * saving a destination in a new temporary when the copies form a cycle (e.g. swapping two variables)
+ * @param copies - pairs of destination and source
+ * @return assignment instructions performing the copies in order
+ */
+std::vector<Instruction> SSAForm::sequenceCopies(std::vector<std::pair<Operand, Operand>> copies) {
+    std::vector<Instruction> sequence;
+
+    while (!copies.empty()) {
+        //Finds a copy whose destination no remaining copy reads
+        auto ready = std::find_if(copies.begin(), copies.end(), [&copies](const std::pair<Operand, Operand>& copy) {
+            return std::none_of(copies.begin(), copies.end(), [&copy](const std::pair<Operand, Operand>& other) {
+                return other.second == copy.first;
+            });
+        });
+
+        if (ready != copies.end()) {
+            sequence.emplace_back(Opcode::ASSIGN, ready->second, Operand(), ready->first);
+            copies.erase(ready);
+        } else {
+            //Every destination is read by another copy, so saves one to break the cycle
+            Operand temp = program.addTemp();
+            Operand destination = copies.front().first;
+            sequence.emplace_back(Opcode::ASSIGN, destination, Operand(), temp);
+
+            for (std::pair<Operand, Operand>& copy : copies) {
+                if (copy.second == destination) copy.second = temp;
+            }
+        }
+    }
+
+    return sequence;
+}
+
+/**
+ * Converts the routine back out of static single assignment form, replacing versions with the temporaries
+ * or variables storing them and phi functions with copies at the end of each predecessor. Where the
+ * predecessor branches elsewhere too, the copies are placed on a new block along the edge
+ */
+void SSAForm::destruct() {
+    std::unordered_map<uint64_t, Operand> storage = assignStorage();
+    std::vector<Instruction>& instructions = routine.getInstructions();
+
+    auto store = [&](const Operand& operand) {
+        if (!isRenamed(operand)) return operand;
+        auto it = storage.find(operand.getKey());
+        return (it == storage.end()) ? operand.withVersion(0) : it->second;
+    };
+
+    for (Instruction& instruction : instructions) {
+        instruction.setArg1(store(instruction.getArg1()));
+        instruction.setArg2(store(instruction.getArg2()));
+        instruction.setResult(store(instruction.getResult()));
+    }
+
+    //Copies to insert before an instruction (taking its label), after it, and as blocks of edges branching to it
+    std::vector<std::vector<Instruction>> before(instructions.size());
+    std::vector<std::vector<Instruction>> after(instructions.size());
+    std::vector<std::vector<Instruction>> edges(instructions.size());
+
+    for (uint32_t block = 0; block < graph.getBlockCount(); block++) {
+        if (!graph.isReachable(block)) continue;
+        const std::array<uint32_t, 2>& successors = graph.getSuccessors(block);
+
+        for (uint32_t i = 0; i < 2; i++) {
+            uint32_t successor = successors[i];
+            if (successor == ControlFlowGraph::NO_BLOCK || phis[successor].empty()) continue;
+            uint32_t index = predecessorIndex(block, successor);
+
+            std::vector<std::pair<Operand, Operand>> copies;
+            for (const Phi& phi : phis[successor]) {
+                Operand destination = store(phi.result);
+                Operand source = store(phi.arguments[index]);
+                if (destination != source) copies.emplace_back(destination, source);
+            }
+            if (copies.empty()) continue;
+
+            std::vector<Instruction> sequence = sequenceCopies(copies);
+            uint32_t last = graph.getEnd(block) - 1;
+            Opcode op = instructions[last].getOp();
+
+            if (successors[1] == ControlFlowGraph::NO_BLOCK) {
+                //Only successor, so copies go at the end of the block, before any branch
+                std::vector<Instruction>& place = (op == Opcode::GOTO || op == Opcode::IFZ) ? before[last] : after[last];
+                place.insert(place.end(), sequence.begin(), sequence.end());
+            } else if (i == 0) {
+                //Falls through to successor, so copies go straight after the conditional branch
+                after[last].insert(after[last].end(), sequence.begin(), sequence.end());
+            } else {
+                //Branches to successor, so branches instead to a new block of copies which then jumps to it
+                Operand label = program.addLabel();
+                uint32_t target = graph.getBegin(successor);
+                sequence.front().setLabel(label.getValue());
+                sequence.emplace_back(Opcode::GOTO, Operand(OperandKind::LABEL, instructions[target].getLabel()),
+                                      Operand(), Operand());
+                if (op == Opcode::GOTO) {
+                    instructions[last].setArg1(label);
+                } else {
+                    instructions[last].setResult(label);
+                }
+                edges[target].insert(edges[target].end(), sequence.begin(), sequence.end());
+            }
+        }
+    }
+
+    std::vector<Instruction> rewritten;
+    std::vector<bool> dropped;
+    rewritten.reserve(instructions.size());
+    //Whether the last instruction kept can fall through to the next
+    bool fallsThrough = false;
+
+    //Adds a sequence of instructions, noting whether each is kept
+    auto emit = [&](const std::vector<Instruction>& sequence, bool drop) {
+        for (const Instruction& instruction : sequence) {
+            rewritten.push_back(instruction);
+            dropped.push_back(drop);
+            if (!drop) fallsThrough = instruction.getOp() != Opcode::GOTO && instruction.getOp() != Opcode::RETURN;
+        }
+    };
+
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        std::vector<Instruction> instruction {instructions[i]};
+
+        if (!edges[i].empty()) {
+            //Code falling through to the block must jump over the copies of edges branching to it
+            if (fallsThrough) {
+                emit({Instruction(Opcode::GOTO, Operand(OperandKind::LABEL, instructions[i].getLabel()), Operand(), Operand())},
+                     false);
+            }
+            emit(edges[i], false);
+        }
+
+        //Copies at the start of the block take its label
+        if (!before[i].empty() && instruction.front().hasLabel()) {
+            before[i].front().setLabel(instruction.front().getLabel());
+            instruction.front().setLabel(Instruction::NO_LABEL);
+        }
+        emit(before[i], false);
+        emit(instruction, removed[i]);
+        emit(after[i], false);
+    }
+
+    //Removed instructions pass their labels on to the instruction after them
+    instructions.swap(rewritten);
+    routine.erase(dropped);
+    phis.clear();
+    removed.assign(routine.getInstructions().size(), false);
+}
+
+/**
+ * Prints the routine in static single assignment form, with the phi functions of each block before its instructions
+ */
+void SSAForm::print() const {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    std::cout << routine.getName(program) << ":" << std::endl;
+
+    for (uint32_t block = 0; block < graph.getBlockCount(); block++) {
+        //Label of block, printed before its phi functions and first instruction not removed
+        uint32_t label = instructions[graph.getBegin(block)].getLabel();
+
+        for (const Phi& phi : phis[block]) {
+            std::string line = (label != Instruction::NO_LABEL) ? program.getLabelName(label) + ": " : "\t ";
+            label = Instruction::NO_LABEL;
+
+            line += program.toString(phi.result) + " = phi(";
+            for (unsigned long i = 0; i < phi.arguments.size(); i++) {
+                line += (i == 0 ? "" : ", ") + program.toString(phi.arguments[i]);
+            }
+            std::cout << " " << line << ");" << std::endl;
+        }
+
+        for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+            if (removed[i]) continue;
+
+            Instruction instruction = instructions[i];
+            instruction.setLabel(label);
+            label = Instruction::NO_LABEL;
+            program.printInstruction(instruction);
+        }
+
+        //Every instruction of the block was removed
+        if (label != Instruction::NO_LABEL) {
+            std::cout << " " << program.getLabelName(label) << ":" << std::endl;
+        }
+    }
+}
+
+/**
+ * Finds the variables used by a routine other than the one declaring them (e.g. globals used in a procedure),
+ * which calls may change and so are not renamed
+ * @param program - owning the table of variables
+ * @param routines - of program
+ * @return whether each variable is used outside the routine declaring it
+ */
+std::vector<bool> SSAForm::findNonLocalVariables(const Program &program, const std::vector<Routine> &routines) {
+    std::vector<bool> nonLocal(program.getVariableCount(), false);
+
+    for (const Routine& routine : routines) {
+        for (const Instruction& instruction : routine.getInstructions()) {
+            for (const Operand* operand : {&instruction.getArg1(), &instruction.getArg2(), &instruction.getResult()}) {
+                if (operand->getKind() != OperandKind::VARIABLE) continue;
+
+                const Symbol* procedure = program.getVariable(*operand)->getProcedure().get();
+                if (program.getProcedureLabel(procedure) != routine.getLabel()) {
+                    nonLocal[operand->getValue()] = true;
+                }
+            }
+        }
+    }
+
+    return nonLocal;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "ControlFlowGraph.h"
+
+/**
+ * Static single assignment form of a routine. Constructing it renames each temporary and local variable
+ * in place, giving every assignment a new version (e.g. x.1, x.2) and placing phi functions where versions
+ * meet, only at blocks where the variable is live (pruned SSA). Version 0 stands for the value on entry.
+ * Variables used by a routine other than the one declaring them are left as they are, as calls may change them.
+ * Destructing it maps versions back to variables, creating temporaries for versions whose lifetimes
+ * overlap, and replaces phi functions with copies sequenced so that they behave as if made in parallel
+ */
+class SSAForm {
+public:
+    //Selects the version of a variable from the predecessor that control came from
+    struct Phi {
+        //Version defined by phi function
+        Operand result;
+
+        //Version from each predecessor, in order of the block's predecessors
+        std::vector<Operand> arguments;
+    };
+
+private:
+    //Program owning the tables of operands, which new temporaries and labels are added to
+    Program& program;
+
+    //Routine in static single assignment form
+    Routine& routine;
+
+    //Control flow graph of routine
+    ControlFlowGraph graph;
+
+    //Whether each variable of the program is used by a routine other than the one declaring it
+    const std::vector<bool>& nonLocal;
+
+    //Phi functions at the start of each block
+    std::vector<std::vector<Phi>> phis;
+
+    //Whether each instruction has been removed, leaving it in place until destruction so that blocks stay the same
+    std::vector<bool> removed;
+
+    //Dominance frontier of each reachable block
+    std::vector<std::vector<uint32_t>> frontiers;
+
+    //Temporaries and variables renamed, by storage key
+    std::unordered_map<uint64_t, uint32_t> indices;
+
+    //Finds the dominance frontier of each reachable block
+    void findFrontiers();
+
+    //Places phi functions for each renamed temporary or variable at the blocks where versions meet and it is live
+    void placePhis();
+
+    //Renames each use and definition to its version, walking the dominator tree
+    void rename();
+
+    //Maps each version to the temporary or variable storing it, so that versions with overlapping lifetimes differ
+    std::unordered_map<uint64_t, Operand> assignStorage();
+
+    //Orders a set of copies made in parallel so that no copy overwrites the source of a later one
+    std::vector<Instruction> sequenceCopies(std::vector<std::pair<Operand, Operand>> copies);
+
+    //Gets the position of a block in the predecessors of another
+    uint32_t predecessorIndex(uint32_t block, uint32_t successor) const;
+public:
+    //Converts a routine into static single assignment form
+    SSAForm(Program& program, Routine& routine, const std::vector<bool>& nonLocal);
+
+    //Getter for routine
+    Routine &getRoutine();
+
+    //Getter for routine
+    const Routine &getRoutine() const;
+
+    //Getter for control flow graph of routine
+    const ControlFlowGraph &getGraph() const;
+
+    //Getter for phi functions at the start of a block
+    std::vector<Phi> &getPhis(uint32_t block);
+
+    //Getter for phi functions at the start of a block
+    const std::vector<Phi> &getPhis(uint32_t block) const;
+
+    //Gets the number of instructions which have not been removed
+    uint32_t getInstructionCount() const;
+
+    //Removes an instruction, which is dropped when converting out of static single assignment form
+    void remove(uint32_t instruction);
+
+    //Returns whether an instruction has been removed
+    bool isRemoved(uint32_t instruction) const;
+
+    //Inserts instructions at the end of blocks, before the jump ending each
+    void insert(const std::vector<std::vector<Instruction>>& inserted);
+
+    //Returns whether an operand is a temporary or variable which is renamed
+    bool isRenamed(const Operand& operand) const;
+
+    //Checks that each version is defined once and that its definition dominates each use
+    void verify() const;
+
+    //Converts the routine back out of static single assignment form
+    void destruct();
+
+    //Prints the routine in static single assignment form
+    void print() const;
+
+    //Finds the variables used by a routine other than the one declaring them
+    static std::vector<bool> findNonLocalVariables(const Program& program, const std::vector<Routine>& routines);
+};
@@ -0,0 +1,128 @@
+#include "TailCallElimination.h"
+#include "Liveness.h"
+
+/**
+ * Replaces the self tail calls of a routine with assignments to its parameters and jumps to the start of its body.
+ * The parameters pushed, the call, the parameters popped and the return are removed, passing their labels on
+ * @param program - owning the tables of operands, which new temporaries and labels are added to
+ * @param routine - to rewrite in place (the main program is left as it is)
+ * @param nonLocal - whether each variable of the program is used by a routine other than the one declaring it
+ */
+TailCallElimination::TailCallElimination(Program &program, Routine &routine, const std::vector<bool> &nonLocal)
+    : program(program), routine(routine), eliminatedCount(0) {
+    if (routine.isProgram() || readsUnassigned(nonLocal)) return;
+
+    formals = program.getParameters(routine.getLabel());
+    std::vector<Instruction>& instructions = routine.getInstructions();
+    std::vector<Instruction> rewritten;
+    std::vector<bool> removed;
+    rewritten.reserve(instructions.size());
+    removed.reserve(instructions.size());
+    Operand entry;
+
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        if (!isTailCall(i)) {
+            rewritten.push_back(instructions[i]);
+            removed.push_back(false);
+            continue;
+        }
+
+        //The first instruction of the body is already written, as calls pushing parameters there are left
+        if (entry.empty()) {
+            if (!rewritten[1].hasLabel()) rewritten[1].setLabel(program.addLabel().getValue());
+            entry = Operand(OperandKind::LABEL, rewritten[1].getLabel());
+        }
+
+        //Parameters are pushed in reverse, so the first is the last pushed
+        std::vector<Operand> arguments;
+        for (uint32_t j = 1; j <= formals.size(); j++) {
+            arguments.push_back(rewritten[rewritten.size() - j].getArg2());
+            removed[removed.size() - j] = true;
+        }
+        for (uint32_t j = i; j <= i + 2; j++) {
+            rewritten.push_back(instructions[j]);
+            removed.push_back(true);
+        }
+        i += 2;
+
+        for (Operand& argument : arguments) {
+            if (argument.getKind() != OperandKind::VARIABLE) continue;
+
+            Operand temp = program.addTemp();
+            rewritten.emplace_back(Opcode::ASSIGN, argument, Operand(), temp);
+            removed.push_back(false);
+            argument = temp;
+        }
+        for (uint32_t j = 0; j < formals.size(); j++) {
+            if (formals[j].empty()) continue;
+
+            rewritten.emplace_back(Opcode::ASSIGN, arguments[j], Operand(), formals[j]);
+            removed.push_back(false);
+        }
+        rewritten.emplace_back(Opcode::GOTO, entry, Operand(), Operand());
+        removed.push_back(false);
+        eliminatedCount++;
+    }
+
+    instructions.swap(rewritten);
+    routine.erase(removed);
+}
+
+/**
+ * Returns whether a variable declared in the routine may be read before it is assigned, as declared without a
+ * value. A new call starts without a value for it, whereas a jump would keep the value from the call it replaces.
+ * Variables used by nested procedures may be read by calls made anywhere, so are assumed to be read first
+ * @param nonLocal - whether each variable of the program is used by a routine other than the one declaring it
+ * @return whether a local variable is live on entry or used by another routine
+ */
+bool TailCallElimination::readsUnassigned(const std::vector<bool> &nonLocal) const {
+    //Tracks every variable, as those used by other routines are checked separately
+    ControlFlowGraph graph(routine);
+    Liveness liveness(routine, graph, std::vector<bool>(nonLocal.size(), false),
+                      std::vector<bool>(routine.getInstructions().size(), false));
+    const uint64_t* entry = liveness.getLiveIn(graph.getEntry());
+
+    for (uint32_t index = 0; index < liveness.getCount(); index++) {
+        const Operand& storage = liveness.getStorage(index);
+        if (storage.getKind() != OperandKind::VARIABLE) continue;
+
+        const std::shared_ptr<Symbol>& symbol = program.getVariable(storage);
+        if (symbol->getObject() != Object::VAR
+            || program.getProcedureLabel(symbol->getProcedure().get()) != routine.getLabel()) continue;
+        if (nonLocal[storage.getValue()] || Liveness::contains(entry, index)) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Returns whether the instruction at an index is a call to the routine whose result is returned immediately:
+ * its parameters pushed, the call, the parameters popped and a return of the call's result. Calls whose
+ * parameters are pushed at the start of the body are left, as they could only recurse forever
+ * @param index - of instruction to check
+ * @return whether instruction is a self tail call
+ */
+bool TailCallElimination::isTailCall(uint32_t index) const {
+    const std::vector<Instruction>& instructions = routine.getInstructions();
+    const Instruction& call = instructions[index];
+    if (call.getOp() != Opcode::CALL || call.getArg2().getValue() != routine.getLabel()
+        || index < formals.size() + 2 || index + 2 >= instructions.size()) return false;
+
+    for (uint32_t i = index - formals.size(); i < index; i++) {
+        if (instructions[i].getOp() != Opcode::PUSH_PARAM) return false;
+    }
+
+    //Instructions jumped to are left, as their labels would be passed on to the assignments replacing them
+    const Instruction& pop = instructions[index + 1];
+    const Instruction& ret = instructions[index + 2];
+    return pop.getOp() == Opcode::POP_PARAMS && ret.getOp() == Opcode::RETURN && ret.getArg2() == call.getResult()
+           && !call.hasLabel() && !pop.hasLabel() && !ret.hasLabel();
+}
+
+/**
+ * Getter for number of tail calls replaced
+ * @return number of self tail calls replaced by jumps
+ */
+uint32_t TailCallElimination::getEliminatedCount() const {
+    return eliminatedCount;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include "Routine.h"
+
+/**
+ * Replaces the calls a procedure makes to itself whose result it immediately returns (self tail calls) with
+ * assignments of the arguments to its parameters and a jump back to the start of its body, so that recursion
+ * runs as a loop in a single call. Arguments which are variables are copied to new temporaries first, so that
+ * assigning one parameter cannot change the argument of another (e.g. f(b, a) swaps a and b). Procedures with a
+ * variable which may be read before it is assigned are left, as the jump would keep its value from the last call
+ */
+class TailCallElimination {
+private:
+    //Program owning the tables of operands, which new temporaries and labels are added to
+    Program& program;
+
+    //Routine to eliminate tail calls of
+    Routine& routine;
+
+    //Parameters of routine, in order
+    std::vector<Operand> formals;
+
+    //Number of tail calls replaced
+    uint32_t eliminatedCount;
+
+    //Returns whether a variable declared in the routine may be read before it is assigned
+    bool readsUnassigned(const std::vector<bool>& nonLocal) const;
+
+    //Returns whether the instruction at an index is a call to the routine whose result is returned immediately
+    bool isTailCall(uint32_t index) const;
+public:
+    //Replaces the self tail calls of a routine with jumps
+    TailCallElimination(Program& program, Routine& routine, const std::vector<bool>& nonLocal);
+
+    //Getter for number of tail calls replaced
+    uint32_t getEliminatedCount() const;
+};
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include "ValueNumbering.h"
+
+/**
+ * Numbers the values of a routine, walking its dominator tree so that the operations available in
+ * a block are those of the blocks dominating it (or only those of the block itself if local)
+ * @param form - of routine, rewritten in place
+ * @param numbering - whether results are reused across blocks
+ */
+ValueNumbering::ValueNumbering(SSAForm &form, Numbering numbering) : form(form), numbering(numbering), removedCount(0) {
+    const ControlFlowGraph& graph = form.getGraph();
+
+    //Blocks being visited, with the number of their children visited and the expressions they made available
+    struct Frame {
+        uint32_t block;
+        uint32_t child;
+        std::vector<Expression> added;
+    };
+    std::vector<Frame> frames;
+
+    //Forgets the expressions a block made available
+    auto forget = [this](std::vector<Expression>& added) {
+        for (const Expression& expression : added) {
+            available.erase(expression);
+        }
+        added.clear();
+    };
+
+    auto visit = [&](uint32_t block) {
+        frames.push_back({block, 0, std::vector<Expression>()});
+        number(block, frames.back().added);
+        if (numbering == Numbering::LOCAL) forget(frames.back().added);
+    };
+
+    visit(graph.getEntry());
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+        BlockRange children = graph.getDominatorChildren(frame.block);
+
+        if (frame.child < children.size()) {
+            visit(children.begin()[frame.child++]);
+        } else {
+            forget(frame.added);
+            frames.pop_back();
+        }
+    }
+}
+
+/**
+ * Gets the value number of an operand, which is the operand it was copied from if any
+ * @param operand - to number
+ * @return operand numbering its value
+ */
+Operand ValueNumbering::getNumber(const Operand &operand) const {
+    auto it = numbers.find(operand.getKey());
+    return (it == numbers.end()) ? operand : it->second;
+}
+
+/**
+ * Gets the operand replacing another, if its computation was removed
+ * @param operand - to replace
+ * @return operand holding the same value
+ */
+Operand ValueNumbering::replace(const Operand &operand) const {
+    if (!form.isRenamed(operand)) return operand;
+
+    auto it = replacements.find(operand.getKey());
+    return (it == replacements.end()) ? operand : it->second;
+}
+
+/**
+ * Returns whether an operand has the same value wherever it is used: immediates, and versions other than
+ * temporaries on entry to the routine (which only calls to _ReadLine assign)
+ * @param operand - to check
+ * @return whether operand is fixed
+ */
+bool ValueNumbering::isFixed(const Operand &operand) const {
+    if (operand.isImmediate() || operand.empty()) return true;
+
+    return form.isRenamed(operand) && !(operand.getKind() == OperandKind::TEMP && operand.getVersion() == 0);
+}
+
+/**
+ * Builds the expression computed by an operation from the value numbers of its arguments. Greater than
+ * comparisons become less than comparisons with their arguments swapped, and the arguments of commutative
+ * operations are ordered, so that equivalent expressions are equal
+ * @param instruction - performing operation
+ * @return expression
+ */
+ValueNumbering::Expression ValueNumbering::makeExpression(const Instruction &instruction) const {
+    Expression expression {instruction.getOp(), getNumber(instruction.getArg1()).getKey(),
+                           getNumber(instruction.getArg2()).getKey()};
+
+    switch (expression.op) {
+        case Opcode::GT:
+            expression.op = Opcode::LT;
+            std::swap(expression.first, expression.second);
+            break;
+        case Opcode::GTE:
+            expression.op = Opcode::LTE;
+            std::swap(expression.first, expression.second);
+            break;
+        case Opcode::PLUS:
+        case Opcode::MULTIPLY:
+        case Opcode::EQ:
+        case Opcode::AND:
+        case Opcode::OR:
+            if (expression.first > expression.second) std::swap(expression.first, expression.second);
+            break;
+        default:
+            break;
+    }
+
+    return expression;
+}
+
+/**
+ * Forgets the expressions in the current block which involve a variable, or are held by it, as it has been assigned
+ * @param variable - assigned
+ */
+void ValueNumbering::kill(const Operand &variable) {
+    local.erase(std::remove_if(local.begin(), local.end(), [&variable](const std::pair<Expression, Operand>& entry) {
+        return entry.first.first == variable.getKey() || entry.first.second == variable.getKey() || entry.second == variable;
+    }), local.end());
+}
+
+/**
+ * Numbers the operations of a block in order. An operation whose expression is already available is removed,
+ * with its uses replaced by the version holding the expression, or becomes a copy of the variable holding it.
+ * Otherwise its expression becomes available, in the blocks dominated by this one if it only involves fixed operands
+ * @param block - to number
+ * @param added - expressions made available to the blocks dominated by block
+ */
+void ValueNumbering::number(uint32_t block, std::vector<Expression> &added) {
+    const ControlFlowGraph& graph = form.getGraph();
+    std::vector<Instruction>& instructions = form.getRoutine().getInstructions();
+    local.clear();
+
+    for (uint32_t i = graph.getBegin(block); i < graph.getEnd(block); i++) {
+        if (form.isRemoved(i)) continue;
+
+        Instruction& instruction = instructions[i];
+        instruction.setArg1(replace(instruction.getArg1()));
+        instruction.setArg2(replace(instruction.getArg2()));
+        Opcode op = instruction.getOp();
+        const Operand result = instruction.getResult();
+
+        //Calls may assign any variable used by other routines
+        if (op == Opcode::CALL) local.clear();
+        if (result.isStorage() && !form.isRenamed(result)) kill(result);
+
+        //Copies share the value number of what they copy
+        if (op == Opcode::ASSIGN && form.isRenamed(result)) {
+            const Operand& source = instruction.getArg1().empty() ? instruction.getArg2() : instruction.getArg1();
+            if (isFixed(source)) numbers[result.getKey()] = getNumber(source);
+            continue;
+        }
+
+        if (!Opcodes::isOperation(op)) continue;
+
+        Expression expression = makeExpression(instruction);
+        bool fixed = isFixed(instruction.getArg1()) && isFixed(instruction.getArg2());
+        Operand holder;
+
+        auto it = available.find(expression);
+        if (fixed && it != available.end()) holder = it->second;
+        for (unsigned long j = 0; j < local.size() && holder.empty(); j++) {
+            if (local[j].first == expression) holder = local[j].second;
+        }
+
+        if (!holder.empty()) {
+            removedCount++;
+
+            if (form.isRenamed(result) && isFixed(holder)) {
+                replacements[result.getKey()] = holder;
+                form.remove(i);
+            } else {
+                //Variable holding the expression may change later, so copies it while it is known to be the same
+                instruction.setOp(Opcode::ASSIGN);
+                instruction.setArg1(holder);
+                instruction.setArg2(Operand());
+            }
+            continue;
+        }
+
+        if (fixed && form.isRenamed(result)) {
+            available.emplace(expression, result);
+            added.push_back(expression);
+        } else if (instruction.getArg1() != result && instruction.getArg2() != result) {
+            local.emplace_back(expression, result);
+        }
+    }
+
+    //Arguments of phi functions are used at the end of this block
+    for (uint32_t successor : graph.getSuccessors(block)) {
+        if (successor == ControlFlowGraph::NO_BLOCK) continue;
+
+        BlockRange predecessors = graph.getPredecessors(successor);
+        uint32_t index = std::find(predecessors.begin(), predecessors.end(), block) - predecessors.begin();
+        for (SSAForm::Phi& phi : form.getPhis(successor)) {
+            phi.arguments[index] = replace(phi.arguments[index]);
+        }
+    }
+}
+
+/**
+ * Getter for number of operations removed
+ * @return number of operations removed or replaced by a copy
+ */
+uint32_t ValueNumbering::getRemovedCount() const {
+    return removedCount;
+}
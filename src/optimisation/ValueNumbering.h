@@ -0,0 +1,85 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "SSA.h"
+
+//Whether value numbering reuses results within each block only, or across the blocks each one dominates
+enum class Numbering : uint8_t {
+    LOCAL,
+    GLOBAL
+};
+
+/**
+ * Hash-based value numbering over a routine in static single assignment form, removing operations which
+ * recompute a value already available. As versions never change, an operation on versions is available
+ * in every block dominated by the one computing it. Operations involving variables used by other routines
+ * are only available until the variable is assigned or a call (which may assign it) is made in the same block
+ */
+class ValueNumbering {
+private:
+    //Operation applied to the value numbers of its arguments
+    struct Expression {
+        Opcode op;
+        uint64_t first;
+        uint64_t second;
+
+        bool operator==(const Expression& other) const {
+            return op == other.op && first == other.first && second == other.second;
+        }
+    };
+
+    //Hashes an expression by combining its operation and arguments
+    struct ExpressionHash {
+        size_t operator()(const Expression& expression) const {
+            size_t hash = std::hash<uint64_t>()(expression.first);
+            hash = hash * 31 + std::hash<uint64_t>()(expression.second);
+            return hash * 31 + static_cast<size_t>(expression.op);
+        }
+    };
+
+    //Routine to number
+    SSAForm& form;
+
+    //Whether results are reused across blocks
+    Numbering numbering;
+
+    //Versions holding each expression of versions and immediates, in the blocks dominating the current one
+    std::unordered_map<Expression, Operand, ExpressionHash> available;
+
+    //Expressions involving variables which may change, with the operand holding each, in the current block
+    std::vector<std::pair<Expression, Operand>> local;
+
+    //Value number of each version copied from another
+    std::unordered_map<uint64_t, Operand> numbers;
+
+    //Version replacing each version whose computation was removed
+    std::unordered_map<uint64_t, Operand> replacements;
+
+    //Number of operations removed
+    uint32_t removedCount;
+
+    //Gets the value number of an operand
+    Operand getNumber(const Operand& operand) const;
+
+    //Gets the operand replacing another, if its computation was removed
+    Operand replace(const Operand& operand) const;
+
+    //Returns whether an operand has the same value wherever it is used
+    bool isFixed(const Operand& operand) const;
+
+    //Builds the expression computed by an operation, ordering its arguments if they can be swapped
+    Expression makeExpression(const Instruction& instruction) const;
+
+    //Forgets the expressions in the current block which involve a variable, as it has been assigned
+    void kill(const Operand& variable);
+
+    //Numbers the operations of a block, recording the expressions added to those available
+    void number(uint32_t block, std::vector<Expression>& added);
+public:
+    //Numbers the values of a routine, removing redundant operations
+    ValueNumbering(SSAForm& form, Numbering numbering);
+
+    //Getter for number of operations removed
+    uint32_t getRemovedCount() const;
+};
@@ -576,7 +576,7 @@ void Parser::orExpr1(std::shared_ptr<TreeNode> node) {
  */
 void Parser::orExpr2(std::shared_ptr<TreeNode> node) {
     if (tokens.front().getType() == TokenType::OR) {
-        std::shared_ptr<TreeNode> child = std::make_shared<TreeNode>(TreeNode("OR"));
+        std::shared_ptr<TreeNode> child = std::make_shared<TreeNode>(TreeNode("OR", TokenType::OR));
         node->addChild(child);
         match(TokenType::OR, child);
         andExpr1(child);
@@ -600,7 +600,7 @@ void Parser::andExpr1(std::shared_ptr<TreeNode> node) {
  */
 void Parser::andExpr2(std::shared_ptr<TreeNode> node) {
     if (tokens.front().getType() == TokenType::AND) {
-        std::shared_ptr<TreeNode> child = std::make_shared<TreeNode>(TreeNode("AND"));
+        std::shared_ptr<TreeNode> child = std::make_shared<TreeNode>(TreeNode("AND", TokenType::AND));
         node->addChild(child);
         match(TokenType::AND, child);
         equalsExpr1(child);
@@ -623,7 +623,7 @@ void Parser::equalsExpr1(std::shared_ptr<TreeNode> node) {
  */
 void Parser::equalsExpr2(std::shared_ptr<TreeNode> node) {
     if (tokens.front().getType() == TokenType::EQ) {
-        std::shared_ptr<TreeNode> child = std::make_shared<TreeNode>(TreeNode("EQ"));
+        std::shared_ptr<TreeNode> child = std::make_shared<TreeNode>(TreeNode("EQ", TokenType::EQ));
         node->addChild(child);
         match(TokenType::EQ, child);
         relopExpr1(child);
@@ -649,22 +649,22 @@ void Parser::relopExpr2(std::shared_ptr<TreeNode> node) {
 
     switch(tokens.front().getType()) {
         case TokenType::LT:
-            child = std::make_shared<TreeNode>(TreeNode("LT"));
+            child = std::make_shared<TreeNode>(TreeNode("LT", TokenType::LT));
             node->addChild(child);
             match(TokenType::LT, child);
             break;
         case TokenType::LTE:
-            child = std::make_shared<TreeNode>(TreeNode("LTE"));
+            child = std::make_shared<TreeNode>(TreeNode("LTE", TokenType::LTE));
             node->addChild(child);
             match(TokenType::LTE, child);
             break;
         case TokenType::GT:
-            child = std::make_shared<TreeNode>(TreeNode("GT"));
+            child = std::make_shared<TreeNode>(TreeNode("GT", TokenType::GT));
             node->addChild(child);
             match(TokenType::GT, child);
             break;
         case TokenType::GTE:
-            child = std::make_shared<TreeNode>(TreeNode("GTE"));
+            child = std::make_shared<TreeNode>(TreeNode("GTE", TokenType::GTE));
             node->addChild(child);
             match(TokenType::GTE, child);
             break;
@@ -696,11 +696,11 @@ void Parser::addExpr2(std::shared_ptr<TreeNode> node) {
     std::shared_ptr<TreeNode> child;
 
     if (t == TokenType::PLUS) {
-        child = std::make_shared<TreeNode>(TreeNode("PLUS"));
+        child = std::make_shared<TreeNode>(TreeNode("PLUS", TokenType::PLUS));
         node->addChild(child);
         match(TokenType::PLUS, child);
     } else if (t == TokenType::MINUS) {
-        child = std::make_shared<TreeNode>(TreeNode("MINUS"));
+        child = std::make_shared<TreeNode>(TreeNode("MINUS", TokenType::MINUS));
         node->addChild(child);
         match(TokenType::MINUS, child);
     } else {
@@ -730,11 +730,11 @@ void Parser::mulExpr2(std::shared_ptr<TreeNode> node) {
     std::shared_ptr<TreeNode> child;
 
     if (t == TokenType::MULTIPLY) {
-        child = std::make_shared<TreeNode>(TreeNode("MULTIPLY"));
+        child = std::make_shared<TreeNode>(TreeNode("MULTIPLY", TokenType::MULTIPLY));
         node->addChild(child);
         match(TokenType::MULTIPLY, node);
     } else if (t == TokenType::DIVIDE) {
-        child = std::make_shared<TreeNode>(TreeNode("DIVIDE"));
+        child = std::make_shared<TreeNode>(TreeNode("DIVIDE", TokenType::DIVIDE));
         node->addChild(child);
         match(TokenType::DIVIDE, node);
     } else {
@@ -756,7 +756,7 @@ void Parser::valueExpr(std::shared_ptr<TreeNode> node) {
 
     switch(t.getType()) {
         case TokenType::NOT:
-            child = std::make_shared<TreeNode>(TreeNode("NOT"));
+            child = std::make_shared<TreeNode>(TreeNode("NOT", TokenType::NOT));
             node->addChild(child);
             match(TokenType::NOT, child);
             valueExpr(child);
@@ -52,5 +52,8 @@ namespace Pattern {
         INT
     };
 
+    //Number of token types, for tables indexed by token type
+    constexpr unsigned long TOKEN_TYPES = static_cast<unsigned long>(TokenType::INT) + 1;
+
 }
 
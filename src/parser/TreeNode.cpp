@@ -1,4 +1,5 @@
 #include "TreeNode.h"
+#include "../semantic/Symbol.h"
 
 /**
  * Constructor for TreeNode
@@ -6,7 +7,8 @@
  */
 TreeNode::TreeNode(std::string l)  :
         label(std::move(l)),
-        token(Token(Pattern::TokenType::NONE, l, 0, 0))
+        token(Token(Pattern::TokenType::NONE, l, 0, 0)),
+        type(Type::NONE)
 {
 }
 
@@ -17,7 +19,22 @@ TreeNode::TreeNode(std::string l)  :
  */
 TreeNode::TreeNode(std::string l, Token t)  :
         label(std::move(l)),
-        token(std::move(t))
+        token(std::move(t)),
+        type(Type::NONE)
+{
+}
+
+/**
+ * Constructor for operator nodes, recording the operator so that
+ * later phases need not look it up from the label
+ * @param l - string label describing operator
+ * @param op - token type of operator
+ */
+TreeNode::TreeNode(std::string l, Pattern::TokenType op)  :
+        label(std::move(l)),
+        token(Token(Pattern::TokenType::NONE, l, 0, 0)),
+        operatorType(op),
+        type(Type::NONE)
 {
 }
 
@@ -58,3 +75,85 @@ const std::vector<std::shared_ptr<TreeNode>> &TreeNode::getChildren() const {
 const std::string &TreeNode::getLabel() const {
     return label;
 }
+
+/**
+ * Getter for operator
+ * @return token type of operator, NONE if not an operator node
+ */
+Pattern::TokenType TreeNode::getOperator() const {
+    return operatorType;
+}
+
+/**
+ * Getter for symbol
+ * @return symbol the identifier was resolved to, nullptr if not an identifier
+ */
+const std::shared_ptr<Symbol> &TreeNode::getSymbol() const {
+    return symbol;
+}
+
+/**
+ * Setter for symbol
+ * @param symbol - the identifier was resolved to
+ */
+void TreeNode::setSymbol(const std::shared_ptr<Symbol> &symbol) {
+    TreeNode::symbol = symbol;
+}
+
+
+/**
+ * Returns whether the value of the node was folded at compile time
+ * @return whether node is constant
+ */
+bool TreeNode::isConstant() const {
+    return constant;
+}
+
+/**
+ * Getter for constant value
+ * @return value folded at compile time (booleans are 0 or 1)
+ */
+long TreeNode::getConstantValue() const {
+    return constantValue;
+}
+
+/**
+ * Records the value of the node folded at compile time, marking it as constant
+ * @param value - folded value (booleans are 0 or 1)
+ */
+void TreeNode::setConstantValue(long value) {
+    constant = true;
+    constantValue = value;
+}
+
+/**
+ * Getter for scope
+ * @return scope opened for the block of a compound node, nullptr if not a compound node
+ */
+const std::shared_ptr<Scope> &TreeNode::getScope() const {
+    return scope;
+}
+
+/**
+ * Setter for scope
+ * @param scope - opened for the block of a compound node
+ */
+void TreeNode::setScope(const std::shared_ptr<Scope> &scope) {
+    TreeNode::scope = scope;
+}
+
+/**
+ * Getter for type
+ * @return type of expression, function call or operator subexpression, NONE if not yet type checked
+ */
+Type TreeNode::getType() const {
+    return type;
+}
+
+/**
+ * Setter for type
+ * @param type - computed for the node during type checking
+ */
+void TreeNode::setType(Type type) {
+    TreeNode::type = type;
+}
\ No newline at end of file
@@ -5,6 +5,10 @@
 
 #include <memory>
 
+class Symbol;
+class Scope;
+enum class Type;
+
 /**
  * Represents a node in the abstract syntax tree
  */
@@ -18,6 +22,25 @@ private:
 
     //Label of node (e.g. non-terminal or terminal value)
     std::string label;
+
+    //Operator of an operator node (e.g. PLUS for a "PLUS" node), NONE otherwise
+    Pattern::TokenType operatorType = Pattern::TokenType::NONE;
+
+    //Symbol an identifier node was resolved to during semantic analysis
+    std::shared_ptr<Symbol> symbol;
+
+    //Scope opened for a compound node's block during semantic analysis
+    std::shared_ptr<Scope> scope;
+
+    //Type computed during type checking (NONE until checked) of an expression or function call node,
+    //or of the subexpression to the right of an operator node, which the operator node contains
+    Type type;
+
+    //Whether the value of an expression node, or of the subexpression of an operator node, is known at compile time
+    bool constant = false;
+
+    //Value folded at compile time if constant (booleans are 0 or 1)
+    long constantValue = 0;
 public:
     const std::string &getLabel() const;
 
@@ -29,6 +52,8 @@ public:
 
     TreeNode(std::string l, Token t);
 
+    TreeNode(std::string l, Pattern::TokenType op);
+
     //Getter for children
     const std::vector<std::shared_ptr<TreeNode>> &getChildren() const;
 
@@ -41,6 +66,36 @@ public:
     //Getter for node token
     const Token &getToken() const;
 
+    //Getter for operator of an operator node
+    Pattern::TokenType getOperator() const;
+
+    //Getter for resolved symbol of identifier
+    const std::shared_ptr<Symbol> &getSymbol() const;
+
+    //Setter for resolved symbol of identifier
+    void setSymbol(const std::shared_ptr<Symbol> &symbol);
+
+    //Getter for type computed during type checking
+    Type getType() const;
+
+    //Setter for type computed during type checking
+    void setType(Type type);
+
+    //Returns whether the value of the node was folded at compile time
+    bool isConstant() const;
+
+    //Getter for value folded at compile time
+    long getConstantValue() const;
+
+    //Records the value of the node folded at compile time
+    void setConstantValue(long value);
+
+    //Getter for scope of compound block
+    const std::shared_ptr<Scope> &getScope() const;
+
+    //Setter for scope of compound block
+    void setScope(const std::shared_ptr<Scope> &scope);
+
 };
 
 
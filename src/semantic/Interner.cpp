@@ -0,0 +1,31 @@
+#include "Interner.h"
+
+/**
+ * Gets the symbol ID of a string, interning it if it has not been seen before
+ * @param name - string to intern
+ * @return symbol ID of string
+ */
+unsigned int Interner::intern(const std::string &name) {
+    auto it = ids.find(name);
+
+    //Return existing ID if string has already been interned
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    //Otherwise assign the next ID
+    auto id = static_cast<unsigned int>(names.size());
+    ids.emplace(name, id);
+    names.emplace_back(name);
+
+    return id;
+}
+
+/**
+ * Getter for the string of a symbol ID
+ * @param id - of interned string
+ * @return interned string
+ */
+const std::string &Interner::getName(unsigned int id) {
+    return names.at(id);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * Maps identifier strings to dense integer symbol IDs,
+ * so that symbol tables can compare and hash integers rather than strings
+ */
+class Interner {
+private:
+    //Maps each interned string to its symbol ID
+    inline static std::unordered_map<std::string, unsigned int> ids;
+
+    //Stores interned strings, indexed by symbol ID
+    inline static std::vector<std::string> names;
+public:
+    //Returns the symbol ID of a string, assigning a new one if not yet interned
+    static unsigned int intern(const std::string& name);
+
+    //Getter for the string of a symbol ID
+    static const std::string& getName(unsigned int id);
+};
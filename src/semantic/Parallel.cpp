@@ -0,0 +1,35 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "Parallel.h"
+
+/**
+ * Runs a task for each index in [0, count), with each thread taking the
+ * next unclaimed index so that long tasks do not hold up the others.
+ * Tasks must not throw, and must only write to state owned by their index.
+ * @param count - number of tasks
+ * @param jobs - maximum number of threads to use (including the calling thread)
+ * @param task - to run for each index
+ */
+void Parallel::forEach(unsigned long count, unsigned int jobs, const std::function<void(unsigned long)>& task) {
+    std::atomic<unsigned long> next(0);
+
+    //Claims and runs tasks until none are left
+    auto worker = [&]() {
+        for (unsigned long i = next++; i < count; i = next++) {
+            task(i);
+        }
+    };
+
+    //Calling thread also works, so only start threads for the remaining jobs
+    std::vector<std::thread> threads;
+    for (unsigned long t = 1; t < jobs && t < count; t++) {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
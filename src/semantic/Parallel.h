@@ -0,0 +1,13 @@
+#pragma once
+
+#include <functional>
+
+/**
+ * Runs independent tasks across a fixed number of threads,
+ * used to check the bodies of top-level procedures concurrently
+ */
+class Parallel {
+public:
+    //Runs task(i) for each i in [0, count) using up to jobs threads, returning once all have finished
+    static void forEach(unsigned long count, unsigned int jobs, const std::function<void(unsigned long)>& task);
+};
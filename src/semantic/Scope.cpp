@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include "Scope.h"
+#include "Interner.h"
 
 /**
  * Getter for list of child scopes in current scope
@@ -14,20 +15,22 @@ const std::vector<std::shared_ptr<Scope>> &Scope::getScopes() const {
  * Getter for symbol table of scope
  * @return symbol table map
  */
-const std::map<std::string, std::pair<Object, Type>> &Scope::getSymbolTable() const {
+const SymbolTable &Scope::getSymbolTable() const {
     return symbolTable;
 }
 
 /**
- * Adds a symbol to the symbol table in the form <id, <obj, type>>
+ * Adds a symbol to the symbol table in the form <id, <obj, type>>,
+ * recording the procedure of the current scope as its owner
  * @param id - of symbol to be added
  * @param obj - (variable or procedure)
  * @param type - of variable or return type of procedure
+ * @return the new symbol
  */
-void Scope::addSymbol(std::string id, Object obj, Type type) {
-    std::pair<Object, Type> value = std::make_pair(obj, type);
-    symbolTable.insert(std::pair<std::string, std::pair<Object, Type>>(id, value));
-    identifiers.emplace_back(std::make_pair(id, std::make_pair(obj, type)));
+std::shared_ptr<Symbol> Scope::addSymbol(const std::string& id, Object obj, Type type) {
+    std::shared_ptr<Symbol> symbol = std::make_shared<Symbol>(Interner::intern(id), obj, type, procedure);
+    symbolTable.insert(symbol);
+    return symbol;
 }
 
 /**
@@ -42,67 +45,55 @@ void Scope::addScope(Block blockVal) {
     scopes.emplace_back(scopePtr);
 }
 
-/**
- * Returns a lit of symbols for a given function
- * @param funcID - function identifier
- * @param scope - to search
- * @return - sequential list of function symbols
- */
-const std::vector<std::pair<std::string, std::pair<Object, Type>>> Scope::getFuncIDs(const std::string& funcID,
-                                                                                     const std::shared_ptr<Scope>& scope) {
-    //If function is declared in current scope
-    if (scope->declared(funcID)) {
-        int numFuncs = 0;
-        //Find position of function in scope
-        for (const std::pair<std::string, std::pair<Object, Type>> id : scope->identifiers) {
-            if (scope->symbolTable[id.first].first == Object::PROC) {
-                numFuncs++;
-                if (id.first == funcID) break;
-            }
-        }
-
-        int currentFunc = 0;
-        //Get identifiers of scope at that position and return them
-        for (const std::shared_ptr<Scope>& s : scope->getScopes()) {
-            if (s->block == Block::PROC) {
-                currentFunc++;
-
-                if (currentFunc == numFuncs) {
-                    return s->identifiers;
-                }
-            }
-        }
-    } else {
-        return getFuncIDs(funcID, scope->parent);
-    }
-}
-
 /**
  * Checks if an object is in scope
  * @param id - of object to check
  * @param obj - whether object is variable or function
  * @return whether object is in scope
  */
-bool Scope::inScope(std::string id, Object obj) {
-    int inScope;
-    //If symbol is not in table
-    if (symbolTable.find(id) == symbolTable.end()) {
-        //Return false if in global scope, or check parent scope
-        return (isGlobal()) ? false : parent->inScope(id, obj);
+bool Scope::inScope(const std::string& id, Object obj) {
+    const std::shared_ptr<Symbol>* symbol = resolve(id);
+
+    //Symbol is not in table of this or any parent scope
+    if (symbol == nullptr) {
+        return false;
     }
 
-    Object entry = (symbolTable[id].first == Object::PROC) ? Object::PROC : Object::VAR;
+    Object entry = ((*symbol)->getObject() == Object::PROC) ? Object::PROC : Object::VAR;
 
     return (entry == obj);
 }
 
+/**
+ * Finds the innermost declaration of a symbol visible from this scope
+ * @param id - of symbol to find
+ * @return pointer to symbol, or nullptr if not declared in this scope or higher
+ */
+const std::shared_ptr<Symbol>* Scope::resolve(const std::string& id) const {
+    unsigned int symbolID = Interner::intern(id);
+    const Scope* scope = this;
+    const std::shared_ptr<Symbol>* symbol;
+
+    //While symbol is not in table, check parent scope
+    while ((symbol = scope->symbolTable.find(symbolID)) == nullptr) {
+        //Return nullptr if in global scope
+        if (scope->isGlobal()) {
+            return nullptr;
+        }
+
+        scope = scope->parent.get();
+    }
+
+    return symbol;
+}
+
 /**
  * Checks if an object was declared in the current scope
  * @param id - of object to check
  * @return whether object is declared in current scope
  */
-bool Scope::declared(std::string id) {
-    return (symbolTable.find(id) != symbolTable.end());
+bool Scope::declared(const std::string& id) {
+    return (symbolTable.find(Interner::intern(id)) != nullptr);
 }
 
 /**
@@ -120,7 +111,8 @@ Scope::Scope() : parent(nullptr),
  */
 Scope::Scope(const Scope& parent, Block block) : parent(std::make_shared<Scope>(parent)),
                                     global(false),
-                                    block(block)
+                                    block(block),
+                                    procedure(parent.procedure)
 {
 }
 
@@ -146,81 +138,50 @@ Block Scope::getBlock() const {
  * @param scope - to search
  * @return - pair of object and type
  */
-const std::pair<Object, Type> &Scope::getSymbol(const std::string id, const std::shared_ptr<Scope>& scope) const {
-    if (scope->symbolTable.find(id) != scope->symbolTable.end()) {
-        return scope->symbolTable.at(id);
-    }
-
-    return getSymbol(id, scope->parent);
+const std::shared_ptr<Symbol> &Scope::getSymbol(const std::string& id, const std::shared_ptr<Scope>& scope) const {
+    return getSymbol(Interner::intern(id), scope);
 }
 
 /**
- * Returns current scope being traversed
+ * Gets the object and type of a given symbol ID from within the current scope
+ * @param id - interned ID of symbol to find
+ * @param scope - to search
+ * @return - symbol
  */
-unsigned long Scope::getCurrent() const {
-    return current;
-}
+const std::shared_ptr<Symbol> &Scope::getSymbol(unsigned int id, const std::shared_ptr<Scope>& scope) const {
+    const Scope* current = scope.get();
+    const std::shared_ptr<Symbol>* symbol;
 
-/**
- * Sets index of current scope
- * @param current - index of current scope
- */
-void Scope::setCurrent(unsigned long current) {
-    Scope::current = current;
+    while ((symbol = current->symbolTable.find(id)) == nullptr) {
+        current = current->parent.get();
+    }
+
+    return *symbol;
 }
 
 /**
  * Gets the return type of the current scope,
  * i.e. if return statement is in function, gets function return type,
  * otherwise if global scope, returns type INT (which denotes an exit code)
- * @param scope - to traverse for return type
  * @return return type of current scope
  */
-Type Scope::getReturnType(const std::shared_ptr<Scope>& scope) {
-    //Return type is INT in global scope for status code
-    if (scope->isGlobal()) {
-        return Type::INT;
-    } else if (scope->block == Block::PROC) {
-        unsigned long funcPos = 0;
-
-        //Record number of functions within parent scope
-        for (const std::shared_ptr<Scope>& s : scope->parent->getScopes()) {
-            //If current scope equals child scope of parent, increment number of functions and break (scope found)
-            if (s == scope) {
-                //Increment the number of
-                funcPos++;
-                break;
-            //otherwise if other function scope found, increment number of functions
-            } else if (s->block == Block::PROC){
-                funcPos++;
-            }
-        }
-
-        //Find ID corresponding to function position
-        unsigned long idPos = 0;
-        for (const std::pair<std::string, std::pair<Object, Type>>& id : parent->identifiers) {
-            //If identifier in parent is a procedure, increment identifier position
-            if (parent->getSymbol(id.first, parent).first == Object::PROC) {
-                idPos++;
-
-                //If ID corresponds to function position, return type of function from symbol table
-                if (idPos == funcPos) {
-                    return parent->getSymbol(id.first, scope).second;
-                }
-            }
-        }
-    }
-
-    //Otherwise if current scope is not procedure or global, check parent block
-    return getReturnType(scope->parent);
+Type Scope::getReturnType() const {
+    //Return type is INT outside of procedures for status code
+    return (procedure == nullptr) ? Type::INT : procedure->getType();
 }
 
 /**
- * Setter for scope parent
- * @param parent - parent node of scope
+ * Getter for procedure
+ * @return procedure the scope belongs to, nullptr if not within a procedure
  */
-void Scope::setParent(const std::shared_ptr<Scope> &parent) {
-    Scope::parent = parent;
+const std::shared_ptr<Symbol> &Scope::getProcedure() const {
+    return procedure;
 }
 
-
+/**
+ * Setter for procedure
+ * @param procedure - the scope belongs to
+ */
+void Scope::setProcedure(const std::shared_ptr<Symbol> &procedure) {
+    Scope::procedure = procedure;
+}
@@ -6,12 +6,7 @@
 #include <map>
 #include <memory>
 #include "../parser/TreeNode.h"
-
-//Distinguishes between variables, parameters and functions in symbol table
-enum class Object {VAR, PARAM, PROC};
-
-//Used to denote variable types and return types
-enum class Type {INT, BOOL, STRING, NONE};
+#include "SymbolTable.h"
 
 //Used to identify the type of scope
 enum class Block {GLOBAL, IF, ELSE, WHILE, PROC};
@@ -21,12 +16,6 @@ enum class Block {GLOBAL, IF, ELSE, WHILE, PROC};
  */
 class Scope {
 private:
-    //Stores list of identifiers in order they were added
-    std::vector<std::pair<std::string, std::pair<Object, Type>>> identifiers;
-
-    //Current scope index
-    unsigned long current = 0;
-
     //Parent scope
     std::shared_ptr<Scope> parent;
 
@@ -39,8 +28,14 @@ private:
     //List of children scopes (e.g. conditional statements in a function)
     std::vector<std::shared_ptr<Scope>> scopes;
 
-    //Symbol table containing [id, object, type] e.g. [x, var, int]
-    std::map<std::string, std::pair<Object, Type>> symbolTable;
+    //Symbol table containing [id, object, type] e.g. [x, var, int], in the order they were added
+    SymbolTable symbolTable;
+
+    //Procedure the scope belongs to (nullptr if not within a procedure)
+    std::shared_ptr<Symbol> procedure;
+
+    //Gets a symbol ID from the current symbol table or a parent scope
+    const std::shared_ptr<Symbol>& getSymbol(unsigned int id, const std::shared_ptr<Scope>& scope) const;
 public:
     //Constructor for global scope
     Scope();
@@ -52,22 +47,25 @@ public:
     const std::vector<std::shared_ptr<Scope>> &getScopes() const;
 
     //Getter for symbol table
-    const std::map<std::string, std::pair<Object, Type>> &getSymbolTable() const;
+    const SymbolTable &getSymbolTable() const;
 
     //Gets a symbol from the current symbol table or a parent scope
-    const std::pair<Object, Type>& getSymbol(std::string id, const std::shared_ptr<Scope>& scope) const;
+    const std::shared_ptr<Symbol>& getSymbol(const std::string& id, const std::shared_ptr<Scope>& scope) const;
 
-    //Adds a symbol to the symbol table of the current scope
-    void addSymbol(std::string id, Object obj, Type type);
+    //Gets the innermost symbol visible from the current scope, or nullptr if not in scope
+    const std::shared_ptr<Symbol>* resolve(const std::string& id) const;
+
+    //Adds a symbol to the symbol table of the current scope and returns it
+    std::shared_ptr<Symbol> addSymbol(const std::string& id, Object obj, Type type);
 
     //Adds a scope to the list of child scopes
     void addScope(Block block);
 
     //Returns whether a variable/function is in scope (i.e. declared in current scope or higher)
-    bool inScope(std::string id, Object obj);
+    bool inScope(const std::string& id, Object obj);
 
     //Returns whether a symbol has been declared in the current scope
-    bool declared(std::string id);
+    bool declared(const std::string& id);
 
     //Returns whether the current scope is the global scope
     bool isGlobal() const;
@@ -75,19 +73,14 @@ public:
     //Getter for the scope/block type
     Block getBlock() const;
 
-    //Gets current index of scope to traverse
-    unsigned long getCurrent() const;
-
-    //Sets current index of scope to traverse
-    void setCurrent(unsigned long current);
-
-    const std::vector<std::pair<std::string, std::pair<Object, Type>>> getFuncIDs(const std::string& funcID, const std::shared_ptr<Scope>& scope);
-
     //Gets the type of return value required by the context of a return statement
-    Type getReturnType(const std::shared_ptr<Scope>& scope);
+    Type getReturnType() const;
+
+    //Getter for procedure the scope belongs to
+    const std::shared_ptr<Symbol> &getProcedure() const;
 
-    //Sets parent scope node
-    void setParent(const std::shared_ptr<Scope> &parent);
+    //Setter for procedure the scope belongs to
+    void setProcedure(const std::shared_ptr<Symbol> &procedure);
 };
 
 
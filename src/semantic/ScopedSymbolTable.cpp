@@ -0,0 +1,72 @@
+#include "ScopedSymbolTable.h"
+
+/**
+ * Opens a new scope, recording the position in the undo log to return to
+ */
+void ScopedSymbolTable::enterScope() {
+    marks.emplace_back(bindings.size());
+}
+
+/**
+ * Closes the innermost scope, popping each of its bindings from the undo log
+ * and restoring the bindings they shadowed
+ */
+void ScopedSymbolTable::exitScope() {
+    unsigned long mark = marks.back();
+    marks.pop_back();
+
+    while (bindings.size() > mark) {
+        const Binding& binding = bindings.back();
+        innermost[binding.symbol->getID()] = binding.shadowed;
+        bindings.pop_back();
+    }
+}
+
+/**
+ * Binds a symbol in the innermost scope, shadowing any outer binding
+ * @param symbol - to bind
+ */
+void ScopedSymbolTable::declare(const std::shared_ptr<Symbol>& symbol) {
+    unsigned int id = symbol->getID();
+
+    //Symbol IDs are dense, so the innermost binding table is indexed directly
+    if (id >= innermost.size()) {
+        innermost.resize(id + 1, 0);
+    }
+
+    bindings.push_back({symbol, marks.size(), innermost[id]});
+    innermost[id] = bindings.size();
+}
+
+/**
+ * Gets the innermost binding of a symbol
+ * @param id - symbol ID to find
+ * @return binding, or nullptr if symbol is not bound in any open scope
+ */
+const ScopedSymbolTable::Binding* ScopedSymbolTable::lookup(unsigned int id) const {
+    if (id >= innermost.size() || innermost[id] == 0) {
+        return nullptr;
+    }
+
+    return &bindings[innermost[id] - 1];
+}
+
+/**
+ * Gets the innermost symbol bound to an ID
+ * @param id - symbol ID to find
+ * @return pointer to symbol, or nullptr if not bound in any open scope
+ */
+const std::shared_ptr<Symbol>* ScopedSymbolTable::resolve(unsigned int id) const {
+    const Binding* binding = lookup(id);
+    return (binding == nullptr) ? nullptr : &binding->symbol;
+}
+
+/**
+ * Checks if a symbol was declared in the innermost scope
+ * @param id - symbol ID to check
+ * @return whether symbol is bound at the current depth
+ */
+bool ScopedSymbolTable::declared(unsigned int id) const {
+    const Binding* binding = lookup(id);
+    return (binding != nullptr && binding->depth == marks.size());
+}
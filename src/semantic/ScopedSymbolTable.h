@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include "SymbolTable.h"
+
+/**
+ * Single symbol table for the whole program, mapping each interned symbol ID
+ * to a stack of bindings (innermost first), with an undo log so that leaving
+ * a scope removes exactly the bindings it declared.
+ * Lookups take constant time regardless of how deeply scopes are nested.
+ */
+class ScopedSymbolTable {
+private:
+    //A declaration of a symbol, linked to the binding it shadows
+    struct Binding {
+        std::shared_ptr<Symbol> symbol;
+        //Nesting depth of the scope declaring the symbol
+        unsigned long depth;
+        //(index + 1) of the shadowed binding of the same symbol, 0 if none
+        unsigned long shadowed;
+    };
+
+    //Innermost binding of each symbol ID as (index + 1) into bindings, 0 if unbound
+    std::vector<unsigned long> innermost;
+
+    //Bindings in the order they were declared, doubling as the undo log
+    std::vector<Binding> bindings;
+
+    //Size of undo log on entry to each open scope
+    std::vector<unsigned long> marks;
+
+    //Gets the innermost binding of a symbol ID, or nullptr if not bound
+    const Binding* lookup(unsigned int id) const;
+public:
+    //Opens a new innermost scope
+    void enterScope();
+
+    //Closes the innermost scope, undoing its declarations
+    void exitScope();
+
+    //Binds a symbol in the innermost scope
+    void declare(const std::shared_ptr<Symbol>& symbol);
+
+    //Gets the innermost symbol bound to an ID, or nullptr if not in scope
+    const std::shared_ptr<Symbol>* resolve(unsigned int id) const;
+
+    //Returns whether a symbol has been declared in the innermost scope
+    bool declared(unsigned int id) const;
+};
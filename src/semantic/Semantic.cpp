@@ -1,12 +1,21 @@
 #include <iostream>
+#include <algorithm>
+#include <limits>
 #include "Semantic.h"
 #include "SemanticException.h"
+#include "Interner.h"
+#include "Parallel.h"
+#include "../type_checking/TypeChecker.h"
 
 /**
  * Constructor for Semantic class, initialises the
  * globalScope variable with a new Scope shared_ptr
+ * @param resolution - whether to resolve identifiers through the scope tree or scoped bindings
+ * @param jobs - number of threads used to check the bodies of top-level procedures
  */
-Semantic::Semantic() : globalScope(std::make_shared<Scope>(Scope()))
+Semantic::Semantic(Resolution resolution, unsigned int jobs) : globalScope(std::make_shared<Scope>(Scope())),
+                                                               resolution(resolution),
+                                                               jobs(jobs)
 {
 }
 
@@ -23,22 +32,132 @@ const std::shared_ptr<Scope> &Semantic::getGlobalScope() const {
  * populating a tree of scopes and their symbol tables if valid,
  * throwing an error if not
  * @param parseTree - to semantically analyse
+ * @param checker - to type check each statement in the same traversal, or null to type check separately
  */
-void Semantic::analyse(const std::shared_ptr<TreeNode> &parseTree) {
+void Semantic::analyse(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<TypeChecker>& checker) {
+    typeChecker = checker;
+
     //Try to generate tree of scopes and symbol tables
     try {
         for (const std::shared_ptr<TreeNode> &node : parseTree->getChildren()) {
             //Validate Compound of global scope
             if (node->getLabel() == "Compound") {
-                validateScope(node, globalScope);
+                if (jobs > 1) {
+                    validateGlobalScope(node);
+                } else {
+                    validateScope(node, globalScope);
+                }
             }
         }
-    //If invalid, catches exception and exits
+    //If invalid, catches exception, prints error and exits
     } catch (SemanticException& e) {
+        std::cout << e.what() << std::endl;
         exit(3);
     }
 }
 
+/**
+ * Validates the global scope in two phases. First the global statements are validated in order,
+ * declaring the signatures of top-level procedures but deferring their bodies. Then the bodies,
+ * which only read the now complete global scope, are validated in parallel. Errors are merged by
+ * position in the source, so that the same error is reported as when validating in order.
+ * @param parseTree - compound of global scope
+ */
+void Semantic::validateGlobalScope(const std::shared_ptr<TreeNode> &parseTree) {
+    //Position of first error, with no error ordered after every statement
+    const unsigned long NONE = std::numeric_limits<unsigned long>::max();
+    std::string error;
+    unsigned long errorSequence = NONE;
+    unsigned long typeErrorSequence = NONE;
+
+    internIdentifiers(parseTree);
+
+    //Validates global statements in order until the first error
+    try {
+        for (sequence = 0; sequence < parseTree->getChildren().size(); sequence++) {
+            const std::shared_ptr<TreeNode>& node = parseTree->getChildren()[sequence];
+
+            if (node->getLabel() == "Statement") {
+                statement(node, globalScope);
+
+                //Records position of first type error in a fused pass
+                if (typeChecker && typeErrorSequence == NONE && !typeChecker->getError().empty()) {
+                    typeErrorSequence = sequence;
+                }
+            }
+        }
+    } catch (SemanticException& e) {
+        error = e.what();
+        errorSequence = sequence;
+    }
+
+    //Bodies after the first error cannot change which error is reported
+    while (!bodies.empty() && bodies.back().sequence > errorSequence) {
+        bodies.pop_back();
+    }
+
+    Parallel::forEach(bodies.size(), jobs, [this](unsigned long i) {
+        validateBody(bodies[i]);
+    });
+
+    //Bodies are in source order, so the first with an error precedes any error in a later global statement
+    for (const ProcedureBody& body : bodies) {
+        if (!body.error.empty()) {
+            error = body.error;
+            break;
+        }
+    }
+
+    if (!error.empty()) {
+        throw SemanticException(error);
+    }
+
+    //Likewise reports the first type error in source order in a fused pass
+    if (typeChecker) {
+        for (const ProcedureBody& body : bodies) {
+            if (!body.typeChecker->getError().empty()) {
+                if (body.sequence < typeErrorSequence) {
+                    typeChecker->setError(body.typeChecker->getError());
+                }
+                break;
+            }
+        }
+    }
+
+    bodies.clear();
+}
+
+/**
+ * Validates the body of a top-level procedure with its own traversal state,
+ * so that bodies can be validated concurrently
+ * @param body - to validate, recording its first error
+ */
+void Semantic::validateBody(ProcedureBody &body) const {
+    Semantic worker(resolution);
+    worker.bindings = std::move(body.bindings);
+    worker.typeChecker = body.typeChecker;
+
+    try {
+        worker.validateScope(body.body, body.body->getScope());
+    } catch (SemanticException& e) {
+        body.error = e.what();
+    }
+}
+
+/**
+ * Interns the identifier of every ID node in a parse tree
+ * @param parseTree - to intern identifiers of
+ */
+void Semantic::internIdentifiers(const std::shared_ptr<TreeNode> &parseTree) {
+    if (parseTree->getToken().getType() == Pattern::TokenType::ID) {
+        Interner::intern(parseTree->getToken().getValue());
+    }
+
+    for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
+        internIdentifiers(node);
+    }
+}
+
 /**
  * Validates the statements of each scope
  * @param parseTree - to validate
@@ -72,12 +191,24 @@ void Semantic::statement(const std::shared_ptr<TreeNode>& parseTree, std::shared
         } else if (label == "Assignment") {
             assignment(node, scope);
         } else if (label == "Function Signature") {
-            functionSig(node, scope);
+            //Defers the body of a top-level procedure when checking bodies in parallel
+            if (jobs > 1 && scope->isGlobal()) {
+                std::shared_ptr<TreeNode> body = functionHeader(node, scope);
+                bodies.push_back({sequence, body, bindings, typeChecker ? std::make_shared<TypeChecker>() : nullptr, ""});
+                closeScope();
+            } else {
+                functionSig(node, scope);
+            }
         } else if (label == "Function Call") {
             functionCall(node, scope);
         } else if (label == "Return Statement") {
             returnStmt(node, scope);
         }
+
+        //Type checks the statement now that its symbols are resolved, if fused with type checking
+        if (typeChecker) {
+            typeChecker->checkStatement(node, scope);
+        }
     }
 }
 
@@ -93,6 +224,7 @@ void Semantic::variable(const std::shared_ptr<TreeNode> &parseTree, std::shared_
     Type type = Type::INT;
     bool isAssignment = false;
     std::shared_ptr<TreeNode> current;
+    std::shared_ptr<TreeNode> idNode;
 
     //Iterates through each symbol in the variable statement
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
@@ -117,6 +249,7 @@ void Semantic::variable(const std::shared_ptr<TreeNode> &parseTree, std::shared_
             case Pattern::TokenType::ID:
                 token = node->getToken();
                 id = node->getToken().getValue();
+                idNode = node;
                 break;
         }
     }
@@ -126,9 +259,11 @@ void Semantic::variable(const std::shared_ptr<TreeNode> &parseTree, std::shared_
 
     //Adds the variable, its ID and type to the symbol table
     if (parseTree->getLabel() == "Formal Parameter") {
-        scope->addSymbol(id, Object::PARAM, type);
+        idNode->setSymbol(declare(id, Object::PARAM, type, scope));
+        //Records the parameter type on the procedure for checking calls
+        scope->getProcedure()->addParameter(type);
     } else {
-        scope->addSymbol(id, Object::VAR, type);
+        idNode->setSymbol(declare(id, Object::VAR, type, scope));
     }
 
     //If the statement was a variable declaration and assignment
@@ -164,7 +299,7 @@ void Semantic::printStmt(const std::shared_ptr<TreeNode> &parseTree, std::shared
         case Pattern::TokenType::GET:
             for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
                 if (node->getToken().getType() == Pattern::TokenType::ID) {
-                    checkIDScope(node->getToken(), Object::VAR, scope);
+                    checkIDScope(node, Object::VAR, scope);
                 }
             }
     }
@@ -191,10 +326,16 @@ void Semantic::conditionalStmt(const std::shared_ptr<TreeNode> &parseTree, std::
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         if (node->getLabel() == "Expression") {
             expression(node, scope);
+            //Type checks the condition before the body, if fused with type checking
+            if (typeChecker) {
+                typeChecker->checkCondition(parseTree, node, scope);
+            }
         } else if (node->getLabel() == "Compound") {
             //Adds a new scope for each compound label encountered
-            scope->addScope(block);
-            validateScope(node, scope->getScopes().back());
+            openScope(block, scope);
+            node->setScope(scope->getScopes().back());
+            validateScope(node, node->getScope());
+            closeScope();
         } else if (node->getLabel() == "Else") {
             conditionalStmt(node, scope);
         }
@@ -210,7 +351,7 @@ void Semantic::assignment(const std::shared_ptr<TreeNode> &parseTree, std::share
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         if (node->getToken().getType() == Pattern::TokenType::ID) {
             //Ensures that the ID being assigned is in scope
-            checkIDScope(node->getToken(), Object::VAR, scope);
+            checkIDScope(node, Object::VAR, scope);
         } else if (node->getLabel() == "Expression") {
             //Validates the expression after the := sign
             expression(node, scope);
@@ -224,7 +365,25 @@ void Semantic::assignment(const std::shared_ptr<TreeNode> &parseTree, std::share
  * @param scope
  */
 void Semantic::functionSig(const std::shared_ptr<TreeNode> &parseTree, std::shared_ptr<Scope> scope) {
+    std::shared_ptr<TreeNode> body = functionHeader(parseTree, scope);
+
+    //Validates the scope of the inner block of the function
+    validateScope(body, body->getScope());
+
+    //Leaves the scope of the function
+    closeScope();
+}
+
+/**
+ * Validates a function signature and its parameters, opening the scope of the function
+ * @param parseTree - function signature to validate
+ * @param scope - to declare function in
+ * @return compound node of function body, annotated with the function scope
+ */
+std::shared_ptr<TreeNode> Semantic::functionHeader(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<Scope>& scope) {
     Type type;
+    std::shared_ptr<TreeNode> body;
+
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         //Records the return type of the function
         switch (node->getToken().getType()) {
@@ -241,9 +400,11 @@ void Semantic::functionSig(const std::shared_ptr<TreeNode> &parseTree, std::shar
                 //Checks if the ID of the function has already been declared in this scope
                 checkIDDeclaration(node->getToken(), scope);
                 //If not previously declared, procedure symbol is added to symbol table
-                scope->addSymbol(node->getToken().getValue(), Object::PROC, type);
-                //New scope for function is also created
-                scope->addScope(Block::PROC);
+                node->setSymbol(declare(node->getToken().getValue(), Object::PROC, type, scope));
+                //New scope for function is also created, linked to and owned by the procedure
+                openScope(Block::PROC, scope);
+                node->getSymbol()->setScope(scope->getScopes().back());
+                scope->getScopes().back()->setProcedure(node->getSymbol());
                 break;
         }
     }
@@ -252,11 +413,14 @@ void Semantic::functionSig(const std::shared_ptr<TreeNode> &parseTree, std::shar
         //Validated any parameters of the procedure
         if (node->getLabel() == "Formal Parameter") {
             variable(node, scope->getScopes().back());
-        //Validates the scope of the inner block of the function
+        //Records the inner block of the function, to be validated in the function scope
         } else if (node->getLabel() == "Compound") {
-            validateScope(node, scope->getScopes().back());
+            node->setScope(scope->getScopes().back());
+            body = node;
         }
     }
+
+    return body;
 }
 
 /**
@@ -269,7 +433,7 @@ void Semantic::functionCall(const std::shared_ptr<TreeNode> &parseTree, std::sha
         switch (node->getToken().getType()) {
             //Ensure that the called procedure ID is in scope
             case Pattern::TokenType::ID:
-                checkIDScope(node->getToken(), Object::PROC, scope);
+                checkIDScope(node, Object::PROC, scope);
                 break;
             default:
                 break;
@@ -308,14 +472,14 @@ void Semantic::expression(const std::shared_ptr<TreeNode> &parseTree, std::share
         if (node->getLabel() == "Function Call") {
             functionCall(node, scope);
         //Recursively validates a subexpression
-        } else if (node->getLabel() == "Expression" || labelToToken.find(node->getLabel()) != labelToToken.end()) {
+        } else if (node->getLabel() == "Expression" || node->getOperator() != Pattern::TokenType::NONE) {
             expression(node, scope);
         }
 
         switch (node->getToken().getType()) {
             //Ensures that the IDs of variables within an expression are in scope
             case Pattern::TokenType::ID:
-                checkIDScope(node->getToken(), Object::VAR, scope);
+                checkIDScope(node, Object::VAR, scope);
                 break;
             default:
                 break;
@@ -324,25 +488,34 @@ void Semantic::expression(const std::shared_ptr<TreeNode> &parseTree, std::share
 }
 
 /**
- * Checks if an ID is in scope, throwing an error if not
- * @param token - to validate ID
+ * Checks if an ID is in scope, throwing an error if not,
+ * and otherwise annotates the ID node with the symbol it resolves to
+ * @param node - ID node to validate
  * @param obj - type of object (variable or function)
  * @param scope - to check symbol table of
  */
-void Semantic::checkIDScope(const Token& token, const Object obj, const std::shared_ptr<Scope>& scope) {
+void Semantic::checkIDScope(const std::shared_ptr<TreeNode>& node, const Object obj, const std::shared_ptr<Scope>& scope) {
+    const Token& token = node->getToken();
     const std::string& id = token.getValue();
     unsigned long line = token.getLineNum();
     unsigned long character = token.getColNum();
 
+    const std::shared_ptr<Symbol>* symbol = (resolution == Resolution::SCOPED_HASH) ? bindings.resolve(Interner::intern(id))
+                                                                                    : scope->resolve(id);
+
+    //Whether innermost symbol is an object of the required kind (parameters count as variables)
+    bool found = symbol != nullptr && (((*symbol)->getObject() == Object::PROC) == (obj == Object::PROC));
+
     //If variable is not in scope, print error message and throw error
-    if (!scope->inScope(id, obj)) {
+    if (!found) {
         std::string err = (obj == Object::VAR) ? "Variable \'" : "Procedure \'";
         err += id + "' on line ";
         err += std::to_string(line) + ", character " + std::to_string(character);
         err += " not in scope";
-        std::cout << err << std::endl;
-        throw SemanticException(nullptr);
+        throw SemanticException(err);
     }
+
+    node->setSymbol(*symbol);
 }
 
 /**
@@ -357,13 +530,58 @@ void Semantic::checkIDDeclaration(const Token& token, const std::shared_ptr<Scop
     unsigned long line = token.getLineNum();
     unsigned long character = token.getColNum();
 
+    bool found = (resolution == Resolution::SCOPED_HASH) ? bindings.declared(Interner::intern(id))
+                                                         : scope->declared(id);
+
     //If variable has been declared
-    if (scope->declared(id)) {
+    if (found) {
         std::string err = "Multiple declaration of member ";
         err += id;
         err += " on line " + std::to_string(line) + ", character " + std::to_string(character);
-        std::cout << err << std::endl;
-        throw SemanticException(nullptr);
+        throw SemanticException(err);
+    }
+}
+
+/**
+ * Adds a symbol to the symbol table of the current scope,
+ * also binding it in the scoped symbol table if resolving through it
+ * @param id - of symbol to add
+ * @param obj - (variable, parameter or procedure)
+ * @param type - of variable or return type of procedure
+ * @param scope - to add symbol to
+ * @return the new symbol
+ */
+std::shared_ptr<Symbol> Semantic::declare(const std::string& id, Object obj, Type type, const std::shared_ptr<Scope>& scope) {
+    std::shared_ptr<Symbol> symbol = scope->addSymbol(id, obj, type);
+
+    if (resolution == Resolution::SCOPED_HASH) {
+        bindings.declare(symbol);
+    }
+
+    return symbol;
+}
+
+/**
+ * Adds a child scope to the current scope, opening a
+ * new scope in the scoped symbol table if resolving through it
+ * @param block - type of child scope
+ * @param scope - to add child scope to
+ */
+void Semantic::openScope(Block block, const std::shared_ptr<Scope>& scope) {
+    scope->addScope(block);
+
+    if (resolution == Resolution::SCOPED_HASH) {
+        bindings.enterScope();
+    }
+}
+
+/**
+ * Closes the innermost scope, undoing its bindings in the
+ * scoped symbol table if resolving through it
+ */
+void Semantic::closeScope() {
+    if (resolution == Resolution::SCOPED_HASH) {
+        bindings.exitScope();
     }
 }
 
@@ -412,8 +630,15 @@ void Semantic::printScope(const std::shared_ptr<Scope>& scope) {
     //Prints an open brace
     std:: cout << "{" << std::endl;
 
+    //Collects the symbols of the symbol table, sorted by ID
+    std::vector<std::pair<std::string, std::pair<Object, Type>>> symbols;
+    for (const std::shared_ptr<Symbol>& entry : scope->getSymbolTable().getEntries()) {
+        symbols.emplace_back(entry->getName(), std::make_pair(entry->getObject(), entry->getType()));
+    }
+    std::sort(symbols.begin(), symbols.end(), [](const auto& a, const auto& b) {return a.first < b.first;});
+
     //Prints each symbol in the symbol table
-    for (std::pair<std::string, std::pair<Object, Type>> symbol : scope->getSymbolTable()) {
+    for (const std::pair<std::string, std::pair<Object, Type>>& symbol : symbols) {
         //Prints the symbol ID and an opening [ indicating the start of a symbol table entry
         std::cout << tabStr << "[\"ID\":" << symbol.first << ", ";
 
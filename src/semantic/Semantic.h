@@ -3,6 +3,13 @@
 
 #include "../parser/TreeNode.h"
 #include "Scope.h"
+#include "ScopedSymbolTable.h"
+
+//Selects how identifiers are resolved during semantic analysis:
+//by searching up the tree of scopes, or in a single table of scoped bindings
+enum class Resolution {SCOPE_TREE, SCOPED_HASH};
+
+class TypeChecker;
 
 class Semantic {
 public:
@@ -13,6 +20,60 @@ private:
     //Scope pointer to global scope
     std::shared_ptr<Scope> globalScope;
 
+    //How identifiers are resolved
+    Resolution resolution;
+
+    //Bindings of symbols in the currently open scopes (only used when resolution is SCOPED_HASH)
+    ScopedSymbolTable bindings;
+
+    //Type checker run on each statement once its symbols are resolved (only set for a fused pass)
+    std::shared_ptr<TypeChecker> typeChecker;
+
+    //Number of threads used to check the bodies of top-level procedures
+    unsigned int jobs;
+
+    //Body of a top-level procedure, checked once all top-level statements and signatures have been
+    struct ProcedureBody {
+        //Position of the procedure's statement in the global scope, ordering errors as in source
+        unsigned long sequence;
+
+        //Compound node of body, annotated with the procedure's scope
+        std::shared_ptr<TreeNode> body;
+
+        //Bindings visible from the body (only used when resolution is SCOPED_HASH)
+        ScopedSymbolTable bindings;
+
+        //Type checker for the body in a fused pass, nullptr otherwise
+        std::shared_ptr<TypeChecker> typeChecker;
+
+        //First semantic error in the body, empty if none
+        std::string error;
+    };
+
+    //Top-level procedure bodies deferred until the global scope has been analysed
+    std::vector<ProcedureBody> bodies;
+
+    //Position of the global statement being analysed
+    unsigned long sequence = 0;
+
+    //Validates the global scope, checking the bodies of top-level procedures in parallel
+    void validateGlobalScope(const std::shared_ptr<TreeNode>& parseTree);
+
+    //Validates a deferred procedure body, recording rather than throwing any error
+    void validateBody(ProcedureBody& body) const;
+
+    //Interns every identifier in the parse tree, so that the interner is only read while checking in parallel
+    static void internIdentifiers(const std::shared_ptr<TreeNode>& parseTree);
+
+    //Adds a symbol to the symbol table of the current scope and returns it
+    std::shared_ptr<Symbol> declare(const std::string& id, Object obj, Type type, const std::shared_ptr<Scope>& scope);
+
+    //Adds a child scope to the current scope and opens it for declarations
+    void openScope(Block block, const std::shared_ptr<Scope>& scope);
+
+    //Closes the innermost open scope
+    void closeScope();
+
     //Validates scope of symbols in parse tree
     void validateScope(const std::shared_ptr<TreeNode>& parseTree, std::shared_ptr<Scope> scope);
 
@@ -35,6 +96,10 @@ private:
     //a new scope for the function
     void functionSig(const std::shared_ptr<TreeNode>& parseTree, std::shared_ptr<Scope> scope);
 
+    //Validates the symbols of a function signature and its parameters, leaving the function scope open and
+    //returning the function's body
+    std::shared_ptr<TreeNode> functionHeader(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& scope);
+
     //Validates the function call ID and actual parameter symbols
     void functionCall(const std::shared_ptr<TreeNode>& parseTree, std::shared_ptr<Scope> scope);
 
@@ -44,38 +109,22 @@ private:
     //Validates the symbols of an expression
     void expression(const std::shared_ptr<TreeNode>& parseTree, std::shared_ptr<Scope> scope);
 
-    //Throws an error if an ID is not in scope
-    void checkIDScope(const Token& token, Object obj, const std::shared_ptr<Scope>& scope);
+    //Throws an error if an ID is not in scope, otherwise annotates the ID node with its symbol
+    void checkIDScope(const std::shared_ptr<TreeNode>& node, Object obj, const std::shared_ptr<Scope>& scope);
 
     //Throws an error if an ID has been declared multiple times in the same scope
     void checkIDDeclaration(const Token& token, const std::shared_ptr<Scope>& scope);
 public:
     //Constructor
-    Semantic();
+    explicit Semantic(Resolution resolution = Resolution::SCOPE_TREE, unsigned int jobs = 1);
 
     //Performs semantic analysis
-    void analyse(const std::shared_ptr<TreeNode>& parseTree);
+    void analyse(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<TypeChecker>& checker = nullptr);
     //Prints the scope tree
     void printTree(const std::shared_ptr<Scope>& global);
 
     //Prints a scope, as well as its inner symbols/scopes
     void printScope(const std::shared_ptr<Scope>& scope);
-
-    //Maps labels to operator token types
-    inline static const std::map<std::string, Pattern::TokenType> labelToToken {
-            {"PLUS", Pattern::TokenType::PLUS},
-            {"MINUS", Pattern::TokenType::MINUS},
-            {"MULTIPLY", Pattern::TokenType::MULTIPLY},
-            {"DIVIDE", Pattern::TokenType::DIVIDE},
-            {"AND", Pattern::TokenType::AND},
-            {"OR", Pattern::TokenType::OR},
-            {"LT", Pattern::TokenType::LT},
-            {"GT", Pattern::TokenType::GT},
-            {"LTE", Pattern::TokenType::LTE},
-            {"GTE", Pattern::TokenType::GTE},
-            {"EQ", Pattern::TokenType::EQ},
-            {"NOT", Pattern::TokenType::NOT},
-    };
 };
 
 
@@ -2,21 +2,22 @@
 
 #include <iostream>
 #include <exception>
+#include <string>
 
 /**
  * Custom exception thrown if an error
- * occurs during lexical or semantic analysis
+ * occurs during lexical or semantic analysis, carrying the message to report
  */
 class SemanticException: public std::exception {
 private:
-    const char* errMsg;
+    std::string errMsg;
 
 public:
-    explicit SemanticException(const char* msg) : errMsg(msg)
+    explicit SemanticException(std::string msg) : errMsg(std::move(msg))
     {
     }
 
     virtual const char* what() const throw() {
-        return errMsg;
+        return errMsg.c_str();
     }
 };
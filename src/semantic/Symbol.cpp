@@ -0,0 +1,89 @@
+#include "Symbol.h"
+#include "Interner.h"
+
+/**
+ * Constructor for Symbol
+ * @param id - interned ID of symbol
+ * @param object - whether symbol is a variable, parameter or procedure
+ * @param type - of variable or return type of procedure
+ * @param procedure - in which symbol is declared, nullptr if global
+ */
+Symbol::Symbol(unsigned int id, Object object, Type type, std::shared_ptr<Symbol> procedure) :
+        id(id),
+        object(object),
+        type(type),
+        procedure(std::move(procedure))
+{
+}
+
+/**
+ * Getter for interned ID
+ * @return symbol ID
+ */
+unsigned int Symbol::getID() const {
+    return id;
+}
+
+/**
+ * Getter for identifier string
+ * @return name of symbol
+ */
+const std::string &Symbol::getName() const {
+    return Interner::getName(id);
+}
+
+/**
+ * Getter for object
+ * @return whether symbol is a variable, parameter or procedure
+ */
+Object Symbol::getObject() const {
+    return object;
+}
+
+/**
+ * Getter for type
+ * @return type of variable or return type of procedure
+ */
+Type Symbol::getType() const {
+    return type;
+}
+
+/**
+ * Getter for procedure
+ * @return procedure the symbol is declared in, nullptr if global
+ */
+const std::shared_ptr<Symbol> &Symbol::getProcedure() const {
+    return procedure;
+}
+
+/**
+ * Getter for scope
+ * @return scope of procedure body, nullptr if not a procedure
+ */
+std::shared_ptr<Scope> Symbol::getScope() const {
+    return scope.lock();
+}
+
+/**
+ * Setter for scope
+ * @param scope - of procedure body
+ */
+void Symbol::setScope(const std::shared_ptr<Scope> &scope) {
+    Symbol::scope = scope;
+}
+
+/**
+ * Getter for parameters
+ * @return types of formal parameters of procedure
+ */
+const std::vector<Type> &Symbol::getParameters() const {
+    return parameters;
+}
+
+/**
+ * Appends a formal parameter type to procedure
+ * @param type - of next formal parameter
+ */
+void Symbol::addParameter(Type type) {
+    parameters.emplace_back(type);
+}
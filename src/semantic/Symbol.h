@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class Scope;
+
+//Distinguishes between variables, parameters and functions in symbol table
+enum class Object {VAR, PARAM, PROC};
+
+//Used to denote variable types and return types
+enum class Type {INT, BOOL, STRING, NONE};
+
+//Number of types, for tables indexed by type
+constexpr unsigned long TYPES = static_cast<unsigned long>(Type::NONE) + 1;
+
+/**
+ * Record of a declared symbol, shared between the symbol table
+ * declaring it and every identifier node in the parse tree resolved to it
+ */
+class Symbol {
+private:
+    //Interned ID of symbol
+    unsigned int id;
+
+    //Whether symbol is a variable, parameter or procedure
+    Object object;
+
+    //Type of variable or return type of procedure
+    Type type;
+
+    //Procedure in which the symbol is declared (nullptr if declared in global scope)
+    std::shared_ptr<Symbol> procedure;
+
+    //Scope of a procedure's body (weak, as the scope tree owns its scopes)
+    std::weak_ptr<Scope> scope;
+
+    //Types of a procedure's formal parameters, in order
+    std::vector<Type> parameters;
+public:
+    //Constructor
+    Symbol(unsigned int id, Object object, Type type, std::shared_ptr<Symbol> procedure);
+
+    //Getter for interned ID
+    unsigned int getID() const;
+
+    //Getter for identifier string
+    const std::string &getName() const;
+
+    //Getter for object
+    Object getObject() const;
+
+    //Getter for type
+    Type getType() const;
+
+    //Getter for owning procedure
+    const std::shared_ptr<Symbol> &getProcedure() const;
+
+    //Getter for scope of procedure body
+    std::shared_ptr<Scope> getScope() const;
+
+    //Setter for scope of procedure body
+    void setScope(const std::shared_ptr<Scope> &scope);
+
+    //Getter for formal parameter types of procedure
+    const std::vector<Type> &getParameters() const;
+
+    //Appends the type of the next formal parameter of procedure
+    void addParameter(Type type);
+};
@@ -0,0 +1,79 @@
+#include "SymbolTable.h"
+
+//Number of slots in a new table (must be a power of two)
+static const unsigned long INITIAL_SLOTS = 8;
+
+/**
+ * Constructor for SymbolTable, starting with a small number of empty slots
+ * as most scopes only declare a handful of symbols
+ */
+SymbolTable::SymbolTable() : slots(INITIAL_SLOTS, 0)
+{
+}
+
+/**
+ * Finds the slot of a symbol ID by linear probing from its hash
+ * @param id - symbol ID to find
+ * @return index of slot containing the ID, or of the empty slot ending the probe
+ */
+unsigned long SymbolTable::probe(unsigned int id) const {
+    unsigned long mask = slots.size() - 1;
+    //Fibonacci hashing spreads the dense symbol IDs across the table
+    unsigned long slot = (id * 2654435769u) & mask;
+
+    while (slots[slot] != 0 && entries[slots[slot] - 1]->getID() != id) {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+/**
+ * Doubles the number of slots and rehashes the entries
+ */
+void SymbolTable::grow() {
+    slots.assign(slots.size() * 2, 0);
+
+    for (unsigned int i = 0; i < entries.size(); i++) {
+        slots[probe(entries[i]->getID())] = i + 1;
+    }
+}
+
+/**
+ * Adds a symbol to the table, keeping the existing entry if the ID is already present
+ * @param symbol - to add
+ */
+void SymbolTable::insert(const std::shared_ptr<Symbol>& symbol) {
+    unsigned long slot = probe(symbol->getID());
+
+    //Symbol is already in table
+    if (slots[slot] != 0) {
+        return;
+    }
+
+    entries.emplace_back(symbol);
+    slots[slot] = static_cast<unsigned int>(entries.size());
+
+    //Keep load factor at or below one half so probes stay short
+    if (entries.size() * 2 > slots.size()) {
+        grow();
+    }
+}
+
+/**
+ * Gets the symbol of a symbol ID
+ * @param id - symbol ID to find
+ * @return pointer to symbol, or nullptr if not in table
+ */
+const std::shared_ptr<Symbol>* SymbolTable::find(unsigned int id) const {
+    unsigned int index = slots[probe(id)];
+    return (index == 0) ? nullptr : &entries[index - 1];
+}
+
+/**
+ * Getter for entries
+ * @return entries in the order they were inserted
+ */
+const std::vector<std::shared_ptr<Symbol>> &SymbolTable::getEntries() const {
+    return entries;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include "Symbol.h"
+
+/**
+ * Flat hash table mapping interned symbol IDs to their symbols,
+ * using open addressing with linear probing
+ */
+class SymbolTable {
+private:
+    //Stores symbols in the order they were added
+    std::vector<std::shared_ptr<Symbol>> entries;
+
+    //Hash slots storing (index + 1) into entries, with 0 marking an empty slot
+    std::vector<unsigned int> slots;
+
+    //Gets the slot holding a symbol ID, or the empty slot where it would be inserted
+    unsigned long probe(unsigned int id) const;
+
+    //Doubles the number of slots and reinserts every entry
+    void grow();
+public:
+    //Constructor
+    SymbolTable();
+
+    //Adds a symbol to the table if its ID is not already present
+    void insert(const std::shared_ptr<Symbol>& symbol);
+
+    //Gets the symbol with a given ID, or nullptr if not present
+    const std::shared_ptr<Symbol>* find(unsigned int id) const;
+
+    //Getter for symbols in insertion order
+    const std::vector<std::shared_ptr<Symbol>> &getEntries() const;
+};
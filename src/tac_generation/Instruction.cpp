@@ -1,52 +1,84 @@
 #include "Instruction.h"
 
+/**
+ * Constructor for Instruction
+ * @param op - operation of instruction
+ * @param arg1 - first argument of instruction
+ * @param arg2 - second argument of instruction
+ * @param result - result of instruction
+ */
+Instruction::Instruction(Opcode op, const Operand &arg1, const Operand &arg2, const Operand &result)
+        : arg1(arg1), arg2(arg2), result(result), label(NO_LABEL), op(op) {}
+
 /**
  * Getter for operation
  * @return operation
  */
-const std::string& Instruction::getOp() const {
+Opcode Instruction::getOp() const {
     return op;
 }
 
+/**
+ * Setter for operation
+ * @param op
+ */
+void Instruction::setOp(Opcode op) {
+    Instruction::op = op;
+}
+
 /**
  * Getter for arg1
  * @return arg1
  */
-const std::string &Instruction::getArg1() const {
+const Operand &Instruction::getArg1() const {
     return arg1;
 }
 
+/**
+ * Setter for arg1
+ * @param arg1
+ */
+void Instruction::setArg1(const Operand &arg1) {
+    Instruction::arg1 = arg1;
+}
+
 /**
  * Getter for arg2
  * @return arg2
  */
-const std::string &Instruction::getArg2() const {
+const Operand &Instruction::getArg2() const {
     return arg2;
 }
 
+/**
+ * Setter for arg2
+ * @param arg2
+ */
+void Instruction::setArg2(const Operand &arg2) {
+    Instruction::arg2 = arg2;
+}
+
 /**
  * Getter for result
  * @return result
  */
-const std::string &Instruction::getResult() const {
+const Operand &Instruction::getResult() const {
     return result;
 }
 
 /**
- * Constructor for Instruction
- * @param op - operation of instruction
- * @param arg1 - first argument of instruction
- * @param arg2 - second argument of instruction
- * @param result - result of instruction
+ * Setter for result
+ * @param result
  */
-Instruction::Instruction(const std::string& op, const std::string &arg1, const std::string &arg2,
-                         const std::string &result) : op(op), arg1(arg1), arg2(arg2), result(result), label(std::string("")) {}
+void Instruction::setResult(const Operand &result) {
+    Instruction::result = result;
+}
 
 /**
  * Getter for label
  * @return label
  */
-const std::string &Instruction::getLabel() const {
+uint32_t Instruction::getLabel() const {
     return label;
 }
 
@@ -54,22 +86,32 @@ const std::string &Instruction::getLabel() const {
  * Setter for label
  * @param label
  */
-void Instruction::setLabel(const std::string &label) {
+void Instruction::setLabel(uint32_t label) {
     Instruction::label = label;
 }
 
 /**
- * Getter for branchInstruction
+ * Returns whether instruction has a label
+ * @return whether label is set
+ */
+bool Instruction::hasLabel() const {
+    return label != NO_LABEL;
+}
+
+/**
+ * Returns whether instruction involves branching
+ * (conditional branches, jumps and calls to library functions which discard their result)
  * @return whether instruction is branch instruction or not
  */
 bool Instruction::isBranchInstruction() const {
-    return branchInstruction;
+    return op == Opcode::IFZ || op == Opcode::GOTO || (op == Opcode::CALL && result.empty());
 }
 
 /**
- * Setter for branchInstruction
- * @param branchInstruction
+ * Returns whether instruction may fail at runtime: divisions, unless the divisor is an immediate other
+ * than zero and -1 (which overflows dividing the smallest integer)
+ * @return whether instruction may fail
  */
-void Instruction::setBranchInstruction(bool branchInstruction) {
-    Instruction::branchInstruction = branchInstruction;
+bool Instruction::mayFail() const {
+    return op == Opcode::DIVIDE && (arg2.getKind() != OperandKind::INT || arg2.getInt() == 0 || arg2.getInt() == -1);
 }
@@ -1,57 +1,158 @@
 #pragma once
 
 #include "../parser/Pattern.h"
+#include "Operand.h"
+
+//Operations of three address code instructions
+enum class Opcode : uint8_t {
+    BEGIN_PROG = 0,
+    END_PROG,
+    BEGIN_FUNC,
+    END_FUNC,
+    ASSIGN,
+    //Operators, in the order of their token types
+    LT,
+    LTE,
+    GT,
+    GTE,
+    EQ,
+    PLUS,
+    MINUS,
+    DIVIDE,
+    MULTIPLY,
+    AND,
+    OR,
+    NOT,
+    PUSH_PARAM,
+    POP_PARAMS,
+    CALL,
+    RETURN,
+    IFZ,
+    GOTO
+};
+
+//Number of opcodes, for tables indexed by opcode
+constexpr unsigned long OPCODES = static_cast<unsigned long>(Opcode::GOTO) + 1;
+
+/**
+ * Conversions between operator token types and opcodes
+ */
+namespace Opcodes {
+    //Returns whether an opcode is an operation (e.g. relational or arithmetic)
+    constexpr bool isOperation(Opcode op) {
+        return op >= Opcode::LT && op <= Opcode::NOT;
+    }
+
+    //Gets the opcode of an operator token type
+    constexpr Opcode fromOperator(Pattern::TokenType type) {
+        switch (type) {
+            case Pattern::TokenType::LT: return Opcode::LT;
+            case Pattern::TokenType::LTE: return Opcode::LTE;
+            case Pattern::TokenType::GT: return Opcode::GT;
+            case Pattern::TokenType::GTE: return Opcode::GTE;
+            case Pattern::TokenType::EQ: return Opcode::EQ;
+            case Pattern::TokenType::PLUS: return Opcode::PLUS;
+            case Pattern::TokenType::MINUS: return Opcode::MINUS;
+            case Pattern::TokenType::DIVIDE: return Opcode::DIVIDE;
+            case Pattern::TokenType::MULTIPLY: return Opcode::MULTIPLY;
+            case Pattern::TokenType::AND: return Opcode::AND;
+            case Pattern::TokenType::OR: return Opcode::OR;
+            default: return Opcode::NOT;
+        }
+    }
+
+    //Gets the operator token type of an operation opcode
+    constexpr Pattern::TokenType toOperator(Opcode op) {
+        switch (op) {
+            case Opcode::LT: return Pattern::TokenType::LT;
+            case Opcode::LTE: return Pattern::TokenType::LTE;
+            case Opcode::GT: return Pattern::TokenType::GT;
+            case Opcode::GTE: return Pattern::TokenType::GTE;
+            case Opcode::EQ: return Pattern::TokenType::EQ;
+            case Opcode::PLUS: return Pattern::TokenType::PLUS;
+            case Opcode::MINUS: return Pattern::TokenType::MINUS;
+            case Opcode::DIVIDE: return Pattern::TokenType::DIVIDE;
+            case Opcode::MULTIPLY: return Pattern::TokenType::MULTIPLY;
+            case Opcode::AND: return Pattern::TokenType::AND;
+            case Opcode::OR: return Pattern::TokenType::OR;
+            case Opcode::NOT: return Pattern::TokenType::NOT;
+            default: return Pattern::TokenType::NONE;
+        }
+    }
+}
 
 /**
- * Models a single three address code instruction (as a quadruple)
+ * Models a single three address code instruction (as a quadruple of an opcode and three operands),
+ * in which the arguments are used as follows:
+ *   ASSIGN      result = arg1 (or arg2 if arg1 is empty)
+ *   operations  result = arg1 op arg2 (arg1 is empty for 'not')
+ *   PUSH_PARAM  pushes arg2
+ *   CALL        calls the procedure labelled by arg2, storing the value returned in result (if any)
+ *   RETURN      returns arg2
+ *   IFZ         branches to the label of result if arg1 is false
+ *   GOTO        branches to the label of arg1
  */
 class Instruction {
 private:
     //quadruple:
 
-    //Stores operation of instruction
-    std::string op;
     //Stores first argument of instruction
-    std::string arg1;
+    Operand arg1;
     //Stores second argument of instruction
-    std::string arg2;
+    Operand arg2;
     //Stores result of instruction
-    std::string result;
+    Operand result;
 
-    //Optional label for conditional branching
-    std::string label;
+    //Optional label for conditional branching (index into the program's labels, NO_LABEL if none)
+    uint32_t label;
 
-    //Whether instruction involves branching
-    bool branchInstruction = false;
+    //Stores operation of instruction
+    Opcode op;
 public:
+    //Label of an instruction without one
+    static constexpr uint32_t NO_LABEL = UINT32_MAX;
+
     //Constructor for instruction
-    Instruction(const std::string& op, const std::string &arg1, const std::string &arg2, const std::string &result);
+    Instruction(Opcode op, const Operand &arg1, const Operand &arg2, const Operand &result);
 
     //Getter for operation
-    const std::string& getOp() const;
+    Opcode getOp() const;
+
+    //Setter for operation
+    void setOp(Opcode op);
 
     //Getter for arg1
-    const std::string &getArg1() const;
+    const Operand &getArg1() const;
+
+    //Setter for arg1
+    void setArg1(const Operand &arg1);
 
     //Getter for arg2
-    const std::string &getArg2() const;
+    const Operand &getArg2() const;
+
+    //Setter for arg2
+    void setArg2(const Operand &arg2);
 
     //Getter for result
-    const std::string &getResult() const;
+    const Operand &getResult() const;
+
+    //Setter for result
+    void setResult(const Operand &result);
 
     //Getter for label
-    const std::string &getLabel() const;
+    uint32_t getLabel() const;
 
     //Setter for label
-    void setLabel(const std::string &label);
+    void setLabel(uint32_t label);
 
-    //Returns whether instruction is branch instruction
-    bool isBranchInstruction() const;
-
-    //Setter for branchInstruction
-    void setBranchInstruction(bool branchInstruction);
+    //Returns whether instruction has a label
+    bool hasLabel() const;
 
+    //Returns whether instruction involves branching
+    bool isBranchInstruction() const;
 
+    //Returns whether instruction may fail at runtime (division by an unknown divisor, zero or -1)
+    bool mayFail() const;
 };
 
-
+static_assert(sizeof(Instruction) <= 32, "Instruction should fit in 32 bytes");
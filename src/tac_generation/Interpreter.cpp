@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <numeric>
+#include "Interpreter.h"
+
+/**
+ * Constructor, finding the instruction of each label, the end of each procedure and the procedure declaring each variable
+ * @param program - to run
+ */
+Interpreter::Interpreter(const Program &program) : program(program) {
+    const std::vector<Instruction>& instructions = program.getInstructions();
+    targets.assign(program.getLabelCount(), UINT32_MAX);
+
+    std::vector<uint32_t> begins;
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        if (instructions[i].hasLabel()) targets[instructions[i].getLabel()] = i;
+
+        if (instructions[i].getOp() == Opcode::BEGIN_FUNC) {
+            begins.push_back(i);
+        } else if (instructions[i].getOp() == Opcode::END_FUNC && !begins.empty()) {
+            skips[begins.back()] = i + 1;
+            begins.pop_back();
+        }
+    }
+
+    for (uint32_t i = 0; i < program.getVariableCount(); i++) {
+        const std::shared_ptr<Symbol>& procedure = program.getVariable(Operand(OperandKind::VARIABLE, i))->getProcedure();
+        owners.push_back(program.getProcedureLabel(procedure.get()));
+    }
+    globals.resize(program.getVariableCount());
+}
+
+/**
+ * Gets the storage of a temporary or variable: variables of the main program are shared, while those of a
+ * procedure belong to the most recent call to it (which encloses any call to a procedure declared inside it)
+ * @param operand - temporary or variable
+ * @return value stored
+ */
+Interpreter::Value &Interpreter::find(const Operand &operand) {
+    if (operand.getKind() == OperandKind::VARIABLE) {
+        uint32_t owner = owners[operand.getValue()];
+        if (owner == Instruction::NO_LABEL) return globals[operand.getValue()];
+
+        for (auto it = frames.rbegin(); it != frames.rend(); it++) {
+            if (it->procedure == owner) return it->values[operand.getStorageKey()];
+        }
+    }
+
+    return frames.back().values[operand.getStorageKey()];
+}
+
+/**
+ * Gets the value of an operand
+ * @param operand - immediate, temporary or variable
+ * @return value of operand
+ */
+Interpreter::Value Interpreter::load(const Operand &operand) {
+    Value value;
+
+    switch (operand.getKind()) {
+        case OperandKind::INT:
+            value.type = Type::INT;
+            value.integer = operand.getInt();
+            break;
+        case OperandKind::BOOL:
+            value.type = Type::BOOL;
+            value.integer = operand.getValue() != 0;
+            break;
+        case OperandKind::STRING: {
+            //Strings are stored as written, so removes their quotes and replaces escaped newlines
+            const std::string& text = program.getString(operand);
+            bool quoted = text.size() >= 2 && text.front() == '"' && text.back() == '"';
+            value.type = Type::STRING;
+            value.string = quoted ? text.substr(1, text.size() - 2) : text;
+
+            for (unsigned long i = value.string.find("\\n"); i != std::string::npos; i = value.string.find("\\n", i)) {
+                value.string.replace(i, 2, "\n");
+            }
+            break;
+        }
+        case OperandKind::TEMP:
+        case OperandKind::VARIABLE:
+            value = find(operand);
+            break;
+        default:
+            break;
+    }
+
+    return value;
+}
+
+/**
+ * Applies an operation to two values, wrapping integers around on overflow
+ * @param op - operation
+ * @param arg1 - first argument (unused by NOT)
+ * @param arg2 - second argument
+ * @return result of operation
+ */
+Interpreter::Value Interpreter::apply(Opcode op, const Value &arg1, const Value &arg2) {
+    Value result;
+    result.type = Type::BOOL;
+    uint32_t first = static_cast<uint32_t>(arg1.integer);
+    uint32_t second = static_cast<uint32_t>(arg2.integer);
+    bool strings = arg1.type == Type::STRING || arg2.type == Type::STRING;
+
+    switch (op) {
+        case Opcode::LT:
+            result.integer = strings ? arg1.string < arg2.string : arg1.integer < arg2.integer;
+            break;
+        case Opcode::LTE:
+            result.integer = strings ? arg1.string <= arg2.string : arg1.integer <= arg2.integer;
+            break;
+        case Opcode::GT:
+            result.integer = strings ? arg1.string > arg2.string : arg1.integer > arg2.integer;
+            break;
+        case Opcode::GTE:
+            result.integer = strings ? arg1.string >= arg2.string : arg1.integer >= arg2.integer;
+            break;
+        case Opcode::EQ:
+            result.integer = arg1.type == arg2.type && arg1.integer == arg2.integer && arg1.string == arg2.string;
+            break;
+        case Opcode::AND:
+            result.integer = arg1.integer && arg2.integer;
+            break;
+        case Opcode::OR:
+            result.integer = arg1.integer || arg2.integer;
+            break;
+        case Opcode::NOT:
+            result.integer = !arg2.integer;
+            break;
+        case Opcode::PLUS:
+            if (strings) {
+                result.type = Type::STRING;
+                result.string = toString(arg1) + toString(arg2);
+                break;
+            }
+            result.type = Type::INT;
+            result.integer = static_cast<int32_t>(first + second);
+            break;
+        case Opcode::MINUS:
+            result.type = Type::INT;
+            result.integer = static_cast<int32_t>(first - second);
+            break;
+        case Opcode::MULTIPLY:
+            result.type = Type::INT;
+            result.integer = static_cast<int32_t>(first * second);
+            break;
+        case Opcode::DIVIDE:
+            if (arg2.integer == 0) throw RuntimeException("Runtime error: division by zero");
+            result.type = Type::INT;
+            result.integer = (arg1.integer == INT_MIN && arg2.integer == -1) ? INT_MIN : arg1.integer / arg2.integer;
+            break;
+        default:
+            break;
+    }
+
+    return result;
+}
+
+/**
+ * Gets the text of a value as printed
+ * @param value - to print
+ * @return text of value
+ */
+std::string Interpreter::toString(const Value &value) {
+    switch (value.type) {
+        case Type::INT:
+            return std::to_string(value.integer);
+        case Type::BOOL:
+            return value.integer ? "true" : "false";
+        default:
+            return value.string;
+    }
+}
+
+/**
+ * Calls a library function: _Print prints the parameters pushed, and _ReadLine reads a line into the one pushed
+ * @param label - of function called
+ * @return whether label is that of a library function
+ */
+bool Interpreter::callLibrary(uint32_t label) {
+    const std::string& name = program.getLabelName(label);
+
+    if (name == "_Print") {
+        for (auto it = parameters.rbegin(); it != parameters.rend(); it++) {
+            std::cout << toString(it->second);
+        }
+    } else if (name == "_ReadLine") {
+        Value value;
+        value.type = Type::STRING;
+        std::getline(std::cin, value.string);
+        if (!parameters.empty()) find(parameters.back().first) = value;
+    } else {
+        return false;
+    }
+
+    parameters.clear();
+    return true;
+}
+
+/**
+ * Runs the program from its BeginProg instruction to its EndProg instruction
+ */
+void Interpreter::run() {
+    const std::vector<Instruction>& instructions = program.getInstructions();
+    uint32_t pc = 0;
+    while (pc < instructions.size() && instructions[pc].getOp() != Opcode::BEGIN_PROG) pc++;
+
+    frames.push_back({Instruction::NO_LABEL, UINT32_MAX, Operand(), {}});
+
+    while (pc < instructions.size()) {
+        const Instruction& instruction = instructions[pc];
+
+        //Procedures declared inside the main program (or another procedure) are only run when called
+        if (instruction.getOp() == Opcode::BEGIN_FUNC) {
+            pc = skips.count(pc) ? skips[pc] : pc + 1;
+            continue;
+        }
+        counts[static_cast<unsigned long>(instruction.getOp())]++;
+        pc++;
+
+        switch (instruction.getOp()) {
+            case Opcode::END_PROG:
+                frames.clear();
+                return;
+            case Opcode::ASSIGN:
+                find(instruction.getResult()) = load(instruction.getArg1().empty() ? instruction.getArg2() : instruction.getArg1());
+                break;
+            case Opcode::PUSH_PARAM:
+                parameters.emplace_back(instruction.getArg2(), load(instruction.getArg2()));
+                break;
+            case Opcode::POP_PARAMS:
+                parameters.clear();
+                break;
+            case Opcode::CALL: {
+                uint32_t label = instruction.getArg2().getValue();
+                if (callLibrary(label)) break;
+                if (targets[label] == UINT32_MAX) throw RuntimeException("Runtime error: call to unknown procedure "
+                                                                         + program.getLabelName(label));
+
+                //Parameters are pushed in reverse, so the first is the last pushed
+                std::vector<std::pair<Operand, Value>> arguments;
+                arguments.swap(parameters);
+                frames.push_back({label, pc, instruction.getResult(), {}});
+                maxDepth = std::max(maxDepth, static_cast<uint32_t>(frames.size() - 1));
+
+                std::vector<Operand> formals = program.getParameters(label);
+                for (unsigned long i = 0; i < formals.size() && i < arguments.size(); i++) {
+                    if (!formals[i].empty()) find(formals[i]) = arguments[arguments.size() - 1 - i].second;
+                }
+                pc = targets[label] + 1;
+                break;
+            }
+            case Opcode::RETURN:
+            case Opcode::END_FUNC: {
+                Value value = (instruction.getOp() == Opcode::RETURN) ? load(instruction.getArg2()) : Value();
+                Frame frame = std::move(frames.back());
+                frames.pop_back();
+
+                if (!frame.result.empty()) find(frame.result) = value;
+                pc = frame.returnAddress;
+                break;
+            }
+            case Opcode::IFZ:
+                if (!load(instruction.getArg1()).integer) pc = targets[instruction.getResult().getValue()];
+                break;
+            case Opcode::GOTO:
+                pc = targets[instruction.getArg1().getValue()];
+                break;
+            default:
+                if (Opcodes::isOperation(instruction.getOp())) {
+                    find(instruction.getResult()) = apply(instruction.getOp(), load(instruction.getArg1()),
+                                                          load(instruction.getArg2()));
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * Gets the number of instructions executed of an opcode
+ * @param op - opcode
+ * @return number executed
+ */
+uint64_t Interpreter::getCount(Opcode op) const {
+    return counts[static_cast<unsigned long>(op)];
+}
+
+/**
+ * Gets the number of instructions executed
+ * @return number executed
+ */
+uint64_t Interpreter::getExecutedCount() const {
+    return std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+}
+
+/**
+ * Getter for largest number of calls which had not yet returned at once
+ * @return deepest call stack, not counting the main program
+ */
+uint32_t Interpreter::getMaxDepth() const {
+    return maxDepth;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+#include "Program.h"
+#include "RuntimeException.h"
+
+/**
+ * Runs a program of three address code, counting the instructions executed of each opcode so that
+ * optimisations can be compared by the work they save. Integers are 32 bit and wrap around on overflow,
+ * as they would on a machine running the program. Each call has its own temporaries and variables of the
+ * procedure called, while variables of the main program are shared by every call. _Print prints the
+ * parameters pushed before it, most recent first, and _ReadLine reads a line into the temporary pushed
+ */
+class Interpreter {
+private:
+    //Value of a temporary or variable
+    struct Value {
+        //Type of value (Type::NONE if never assigned)
+        Type type = Type::NONE;
+
+        //Integer or boolean value (booleans are 0 or 1)
+        int32_t integer = 0;
+
+        //String value
+        std::string string;
+    };
+
+    //Call to a procedure (or the main program) which has not yet returned
+    struct Frame {
+        //Label of procedure (Instruction::NO_LABEL for the main program)
+        uint32_t procedure;
+
+        //Index of instruction to return to
+        uint32_t returnAddress;
+
+        //Temporary or variable to store the value returned in
+        Operand result;
+
+        //Temporaries and variables of the procedure, by storage key
+        std::unordered_map<uint64_t, Value> values;
+    };
+
+    //Program to run
+    const Program& program;
+
+    //Index of the instruction with each label (UINT32_MAX if none)
+    std::vector<uint32_t> targets;
+
+    //Index of the instruction after the EndFunc of each BeginFunc, skipped when reached without a call
+    std::unordered_map<uint32_t, uint32_t> skips;
+
+    //Label of the procedure declaring each variable (Instruction::NO_LABEL for the main program)
+    std::vector<uint32_t> owners;
+
+    //Values of the variables of the main program
+    std::vector<Value> globals;
+
+    //Calls which have not yet returned, the most recent last
+    std::vector<Frame> frames;
+
+    //Parameters pushed since the last call, with the operand each was pushed from
+    std::vector<std::pair<Operand, Value>> parameters;
+
+    //Number of instructions executed of each opcode
+    std::array<uint64_t, OPCODES> counts {};
+
+    //Largest number of calls which had not yet returned at once
+    uint32_t maxDepth = 0;
+
+    //Gets the storage of a temporary or variable
+    Value& find(const Operand& operand);
+
+    //Gets the value of an operand
+    Value load(const Operand& operand);
+
+    //Applies an operation to two values
+    static Value apply(Opcode op, const Value& arg1, const Value& arg2);
+
+    //Gets the text of a value as printed
+    static std::string toString(const Value& value);
+
+    //Calls a library function (e.g. _Print), returning whether the label is one
+    bool callLibrary(uint32_t label);
+public:
+    //Constructor
+    explicit Interpreter(const Program& program);
+
+    //Runs the program from its BeginProg instruction to its EndProg instruction
+    void run();
+
+    //Gets the number of instructions executed of an opcode
+    uint64_t getCount(Opcode op) const;
+
+    //Gets the number of instructions executed
+    uint64_t getExecutedCount() const;
+
+    //Getter for largest number of calls which had not yet returned at once
+    uint32_t getMaxDepth() const;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+
+//Distinguishes what the value of an operand refers to
+enum class OperandKind : uint8_t {
+    NONE = 0,  //Empty argument of an instruction
+    TEMP,      //Temporary variable, by number
+    VARIABLE,  //Variable or parameter, by index into the program's variables
+    INT,       //Integer immediate, by value
+    BOOL,      //Boolean immediate, by value
+    STRING,    //String immediate, by index into the program's string pool
+    LABEL      //Branch target or procedure, by index into the program's labels
+};
+
+/**
+ * Models a single argument of a three address code instruction,
+ * packed into 8 bytes so that instructions can be stored and compared cheaply
+ */
+class Operand {
+private:
+    //What the value refers to
+    uint32_t kind : 8;
+
+    //Version of a temporary or variable, distinguishing its definitions
+    uint32_t version : 24;
+
+    //Number, index or immediate value of operand
+    uint32_t value;
+public:
+    //Constructor for empty operand
+    constexpr Operand() : kind(0), version(0), value(0) {}
+
+    //Constructor for operand of a given kind and value
+    constexpr Operand(OperandKind kind, uint32_t value, uint32_t version = 0)
+        : kind(static_cast<uint32_t>(kind)), version(version), value(value) {}
+
+    //Creates an integer immediate
+    static constexpr Operand integer(int32_t value) {
+        return Operand(OperandKind::INT, static_cast<uint32_t>(value));
+    }
+
+    //Creates a boolean immediate
+    static constexpr Operand boolean(bool value) {
+        return Operand(OperandKind::BOOL, value ? 1 : 0);
+    }
+
+    //Getter for kind
+    constexpr OperandKind getKind() const {
+        return static_cast<OperandKind>(kind);
+    }
+
+    //Getter for value
+    constexpr uint32_t getValue() const {
+        return value;
+    }
+
+    //Getter for value of an integer immediate
+    constexpr int32_t getInt() const {
+        return static_cast<int32_t>(value);
+    }
+
+    //Getter for version
+    constexpr uint32_t getVersion() const {
+        return version;
+    }
+
+    //Setter for version
+    void setVersion(uint32_t version) {
+        Operand::version = version;
+    }
+
+    //Gets a copy of operand with a different version
+    constexpr Operand withVersion(uint32_t version) const {
+        return Operand(getKind(), value, version);
+    }
+
+    //Gets a key identifying the storage (temporary or variable) of operand, ignoring its version
+    constexpr uint64_t getStorageKey() const {
+        return (static_cast<uint64_t>(kind) << 32) | value;
+    }
+
+    //Gets a key identifying operand, including its version
+    constexpr uint64_t getKey() const {
+        return (static_cast<uint64_t>(kind) << 56) | (static_cast<uint64_t>(version) << 32) | value;
+    }
+
+    //Returns whether operand is empty
+    constexpr bool empty() const {
+        return getKind() == OperandKind::NONE;
+    }
+
+    //Returns whether operand is an immediate value known at compile time
+    constexpr bool isImmediate() const {
+        return getKind() == OperandKind::INT || getKind() == OperandKind::BOOL || getKind() == OperandKind::STRING;
+    }
+
+    //Returns whether operand names storage which instructions can assign to
+    constexpr bool isStorage() const {
+        return getKind() == OperandKind::TEMP || getKind() == OperandKind::VARIABLE;
+    }
+
+    constexpr bool operator==(const Operand& other) const {
+        return kind == other.kind && version == other.version && value == other.value;
+    }
+
+    constexpr bool operator!=(const Operand& other) const {
+        return !(*this == other);
+    }
+};
+
+static_assert(sizeof(Operand) == 8, "Operand should pack into 8 bytes");
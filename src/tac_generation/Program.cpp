@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include "Program.h"
+#include "../parser/Lexer.h"
+#include "../semantic/Scope.h"
+
+//Names of opcodes as printed, indexed by opcode
+static const std::array<std::string, OPCODES> OPCODE_NAMES {
+        "BeginProg", "EndProg", "BeginFunc", "EndFunc", "ASSIGN",
+        "LT", "LTE", "GT", "GTE", "EQ", "PLUS", "MINUS", "DIVIDE", "MULTIPLY", "AND", "OR", "NOT",
+        "PushParam", "PopParams", "Call", "Return", "IfZ", "Goto"
+};
+
+/**
+ * Getter for list of instructions
+ * @return instructions - list of instructions
+ */
+std::vector<Instruction> &Program::getInstructions() {
+    return instructions;
+}
+
+/**
+ * Getter for list of instructions
+ * @return instructions - list of instructions
+ */
+const std::vector<Instruction> &Program::getInstructions() const {
+    return instructions;
+}
+
+/**
+ * Appends an instruction to the program
+ * @param instruction - to append
+ */
+void Program::addInstruction(const Instruction &instruction) {
+    instructions.emplace_back(instruction);
+}
+
+/**
+ * Creates a new temporary variable (e.g. t1, t2, t3...)
+ * @return operand of temporary variable
+ */
+Operand Program::addTemp() {
+    return Operand(OperandKind::TEMP, tempNum++);
+}
+
+/**
+ * Gets the operand of a variable or parameter, adding it to the table if not yet present
+ * @param symbol - of variable
+ * @return operand of variable
+ */
+Operand Program::addVariable(const std::shared_ptr<Symbol> &symbol) {
+    auto inserted = variableIndices.emplace(symbol.get(), variables.size());
+
+    if (inserted.second) {
+        variables.emplace_back(symbol);
+
+        //Lengthens the prefix of temporary variable names until none can be mistaken for a variable
+        if (isTempName(symbol->getName())) {
+            do {
+                tempPrefix = "_" + tempPrefix;
+            } while (std::any_of(variables.begin(), variables.end(),
+                                 [this](const std::shared_ptr<Symbol>& variable) { return isTempName(variable->getName()); }));
+        }
+    }
+
+    return Operand(OperandKind::VARIABLE, inserted.first->second);
+}
+
+/**
+ * Gets the operand of a string literal, adding it to the pool if not yet present
+ * @param string - literal as written in source
+ * @return operand of string
+ */
+Operand Program::addString(const std::string &string) {
+    auto inserted = stringIndices.emplace(string, strings.size());
+
+    if (inserted.second) {
+        strings.emplace_back(string);
+    }
+
+    return Operand(OperandKind::STRING, inserted.first->second);
+}
+
+/**
+ * Creates a new conditional label (e.g. L0, L1, L2...)
+ * @return operand of label
+ */
+Operand Program::addLabel() {
+    labels.emplace_back("L" + std::to_string(labelNum++));
+    return Operand(OperandKind::LABEL, labels.size() - 1);
+}
+
+/**
+ * Gets the label of a procedure, adding it to the table if not yet present
+ * @param symbol - of procedure
+ * @return operand of label
+ */
+Operand Program::addProcedure(const std::shared_ptr<Symbol> &symbol) {
+    auto inserted = procedureLabels.emplace(symbol.get(), labels.size());
+
+    if (inserted.second) {
+        labels.emplace_back(symbol->getName());
+    }
+
+    return Operand(OperandKind::LABEL, inserted.first->second);
+}
+
+/**
+ * Gets the label of a library function (e.g. _Print), adding it to the table if not yet present
+ * @param name - of library function
+ * @return operand of label
+ */
+Operand Program::addLibraryFunction(const std::string &name) {
+    auto inserted = libraryLabels.emplace(name, labels.size());
+
+    if (inserted.second) {
+        labels.emplace_back(name);
+    }
+
+    return Operand(OperandKind::LABEL, inserted.first->second);
+}
+
+/**
+ * Getter for the symbol of a variable operand
+ * @param operand - variable
+ * @return symbol of variable
+ */
+const std::shared_ptr<Symbol> &Program::getVariable(const Operand &operand) const {
+    return variables[operand.getValue()];
+}
+
+/**
+ * Getter for the text of a string operand
+ * @param operand - string
+ * @return string as written in source
+ */
+const std::string &Program::getString(const Operand &operand) const {
+    return strings[operand.getValue()];
+}
+
+/**
+ * Getter for the name of a label
+ * @param label - index of label
+ * @return name of label
+ */
+const std::string &Program::getLabelName(uint32_t label) const {
+    return labels[label];
+}
+
+/**
+ * Getter for the label of a procedure
+ * @param symbol - of procedure (nullptr for the main program)
+ * @return label of procedure, Instruction::NO_LABEL for the main program or an unknown procedure
+ */
+uint32_t Program::getProcedureLabel(const Symbol *symbol) const {
+    auto it = procedureLabels.find(symbol);
+    return (it == procedureLabels.end()) ? Instruction::NO_LABEL : it->second;
+}
+
+/**
+ * Gets the variables of a procedure's parameters, in the order they are declared (and so popped by a call)
+ * @param label - of procedure
+ * @return operand of each parameter, or an empty operand for parameters which no instruction uses
+ */
+std::vector<Operand> Program::getParameters(uint32_t label) const {
+    std::vector<Operand> parameters;
+
+    for (const auto& procedure : procedureLabels) {
+        std::shared_ptr<Scope> scope = procedure.first->getScope();
+        if (procedure.second != label || !scope) continue;
+
+        for (const std::shared_ptr<Symbol>& symbol : scope->getSymbolTable().getEntries()) {
+            if (symbol->getObject() != Object::PARAM) continue;
+
+            auto it = variableIndices.find(symbol.get());
+            parameters.push_back((it == variableIndices.end()) ? Operand() : Operand(OperandKind::VARIABLE, it->second));
+        }
+    }
+
+    return parameters;
+}
+
+/**
+ * Getter for the number of variables in the table
+ * @return number of variables
+ */
+uint32_t Program::getVariableCount() const {
+    return variables.size();
+}
+
+/**
+ * Getter for the number of temporary variables created
+ * @return one more than the number of the last temporary variable
+ */
+uint32_t Program::getTempCount() const {
+    return tempNum;
+}
+
+/**
+ * Getter for the number of labels created
+ * @return number of labels
+ */
+uint32_t Program::getLabelCount() const {
+    return labels.size();
+}
+
+/**
+ * Returns whether a name is that of a temporary variable with the current prefix (e.g. t1)
+ * @param name - to check
+ * @return whether name is prefix followed by digits
+ */
+bool Program::isTempName(const std::string &name) const {
+    return name.size() > tempPrefix.size() && name.compare(0, tempPrefix.size(), tempPrefix) == 0
+           && std::all_of(name.begin() + tempPrefix.size(), name.end(), [](char c) { return isdigit(c); });
+}
+
+/**
+ * Gets the text of an operand as printed
+ * @param operand - to convert
+ * @return text of operand (empty if none)
+ */
+std::string Program::toString(const Operand &operand) const {
+    //Versions of a temporary or variable in static single assignment form are suffixed (e.g. x.2)
+    std::string version = (operand.getVersion() != 0) ? "." + std::to_string(operand.getVersion()) : "";
+
+    switch (operand.getKind()) {
+        case OperandKind::TEMP:
+            return tempPrefix + std::to_string(operand.getValue()) + version;
+        case OperandKind::VARIABLE:
+            return getVariable(operand)->getName() + version;
+        case OperandKind::INT:
+            return std::to_string(operand.getInt());
+        case OperandKind::BOOL:
+            return operand.getValue() ? "true" : "false";
+        case OperandKind::STRING:
+            return getString(operand);
+        case OperandKind::LABEL:
+            return getLabelName(operand.getValue());
+        default:
+            return std::string();
+    }
+}
+
+/**
+ * Prints the list of instructions
+ * @param heading - printed above instructions
+ */
+void Program::print(const std::string &heading) const {
+    std::cout << heading << std::endl;
+    std::cout << "------------------------------------------------------------------" << std::endl;
+
+    //Print each three address code instruction in program
+    for (const Instruction& instruction : instructions) {
+        printInstruction(instruction);
+    }
+}
+
+/**
+ * Prints given instruction
+ * @param instruction - to print
+ */
+void Program::printInstruction(const Instruction &instruction) const {
+    std::string instructionStr;
+    const std::string& op = OPCODE_NAMES[static_cast<unsigned long>(instruction.getOp())];
+
+    //If conditional instruction, simply print the values not as an assignment
+    if (instruction.isBranchInstruction()) {
+        instructionStr += (instruction.hasLabel()) ? " " + getLabelName(instruction.getLabel()) + ": " : "\t ";
+        instructionStr += op + " ";
+        instructionStr += toString(instruction.getArg1()) + " ";
+        //Conditional branches read as 'IfZ t1 Goto L0'
+        instructionStr += (instruction.getOp() == Opcode::IFZ) ? "Goto " : toString(instruction.getArg2()) + " ";
+        instructionStr += toString(instruction.getResult()) + " ";
+        std::cout << instructionStr << ";" << std::endl;
+        return;
+    }
+
+    //Otherwise generate string to print:
+
+    //If instruction has a result
+    if (!instruction.getResult().empty()) {
+        //Add equals sign
+        instructionStr += toString(instruction.getResult()) + " = ";
+    }
+
+    //Add first argument if one is present
+    if (!instruction.getArg1().empty()) {
+        instructionStr += toString(instruction.getArg1()) + " ";
+    }
+
+    //If not assignment
+    if (instruction.getOp() != Opcode::ASSIGN) {
+        //If operation of instruction is arithmetic/logical/relational
+        if (Opcodes::isOperation(instruction.getOp())) {
+            //Get symbol using operation token
+            instructionStr += Lexer::TOKEN_STRINGS[static_cast<unsigned long>(Opcodes::toOperator(instruction.getOp()))];
+        } else {
+            //Otherwise simply append the operation string (e.g. being, end, PushParam etc)
+            instructionStr += op + " ";
+        }
+    }
+
+    //Append second argument (if only one argument is present second one is)
+    instructionStr += " " + toString(instruction.getArg2()) + ";";
+
+    //Print label prepending instruction if not empty
+    std::string temp = instructionStr;
+    instructionStr = (instruction.hasLabel()) ? getLabelName(instruction.getLabel()) + ": " : "\t ";
+    instructionStr += temp;
+
+    //Print instruction string
+    std::cout << " " + instructionStr << std::endl;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Instruction.h"
+#include "../semantic/Symbol.h"
+
+/**
+ * Stores a program of three address code instructions, along with the
+ * tables of variables, strings and labels which their operands index into
+ */
+class Program {
+private:
+    //Stores list of three address code instructions
+    std::vector<Instruction> instructions;
+
+    //Symbols of variables and parameters, indexed by variable operands
+    std::vector<std::shared_ptr<Symbol>> variables;
+    //Maps each symbol to its variable index
+    std::unordered_map<const Symbol*, uint32_t> variableIndices;
+
+    //String literals as written in source (including quotes), indexed by string operands
+    std::vector<std::string> strings;
+    //Maps each string to its index in the pool
+    std::unordered_map<std::string, uint32_t> stringIndices;
+
+    //Names of branch targets and procedures, indexed by label operands
+    std::vector<std::string> labels;
+    //Maps each procedure symbol to its label
+    std::unordered_map<const Symbol*, uint32_t> procedureLabels;
+    //Maps each library function (e.g. _Print) to its label
+    std::unordered_map<std::string, uint32_t> libraryLabels;
+
+    //Number of the next temporary variable (counts from 1, as in the example file)
+    uint32_t tempNum = 1;
+    //Prefix of the printed names of temporary variables, lengthened if a variable would share a name with one
+    std::string tempPrefix = "t";
+    //Number of the next conditional label (counts from 0, as in the example file)
+    uint32_t labelNum = 0;
+public:
+    //Getter for list of instructions
+    std::vector<Instruction> &getInstructions();
+
+    //Getter for list of instructions
+    const std::vector<Instruction> &getInstructions() const;
+
+    //Appends an instruction to the program
+    void addInstruction(const Instruction& instruction);
+
+    //Creates a new temporary variable
+    Operand addTemp();
+
+    //Gets the operand of a variable or parameter, adding it to the table if not yet present
+    Operand addVariable(const std::shared_ptr<Symbol>& symbol);
+
+    //Gets the operand of a string literal, adding it to the pool if not yet present
+    Operand addString(const std::string& string);
+
+    //Creates a new conditional label (e.g. L0, L1, L2...)
+    Operand addLabel();
+
+    //Gets the label of a procedure, adding it to the table if not yet present
+    Operand addProcedure(const std::shared_ptr<Symbol>& symbol);
+
+    //Gets the label of a library function, adding it to the table if not yet present
+    Operand addLibraryFunction(const std::string& name);
+
+    //Getter for the symbol of a variable operand
+    const std::shared_ptr<Symbol> &getVariable(const Operand& operand) const;
+
+    //Getter for the text of a string operand
+    const std::string &getString(const Operand& operand) const;
+
+    //Getter for the name of a label
+    const std::string &getLabelName(uint32_t label) const;
+
+    //Getter for the label of a procedure (Instruction::NO_LABEL for the main program or an unknown procedure)
+    uint32_t getProcedureLabel(const Symbol* symbol) const;
+
+    //Gets the variables of a procedure's parameters, in the order they are declared
+    std::vector<Operand> getParameters(uint32_t label) const;
+
+    //Getter for the number of variables in the table
+    uint32_t getVariableCount() const;
+
+    //Getter for the number of temporary variables created (including the unused number 0)
+    uint32_t getTempCount() const;
+
+    //Getter for the number of labels created
+    uint32_t getLabelCount() const;
+
+    //Returns whether a name is that of a temporary variable with the current prefix
+    bool isTempName(const std::string& name) const;
+
+    //Gets the text of an operand as printed
+    std::string toString(const Operand& operand) const;
+
+    //Prints the list of instructions under a heading
+    void print(const std::string& heading = "Three Address Code Generation:") const;
+
+    //Prints a given instruction
+    void printInstruction(const Instruction& instruction) const;
+};
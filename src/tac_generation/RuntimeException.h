@@ -0,0 +1,22 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+/**
+ * Custom error which is thrown if the three address code
+ * cannot be run, e.g. dividing by zero, carrying the message to report
+ */
+class RuntimeException : public std::exception {
+private:
+    std::string errMsg;
+
+public:
+    explicit RuntimeException(std::string msg) : errMsg(std::move(msg))
+    {
+    }
+
+    virtual const char* what() const throw() {
+        return errMsg.c_str();
+    }
+};
@@ -1,32 +1,23 @@
 #include <vector>
-#include <map>
+#include <stack>
 #include "TAC_Generator.h"
-#include "../semantic/Semantic.h"
-#include "../parser/Lexer.h"
+#include "../semantic/Symbol.h"
 
 /**
- * Gets next temporary variable ID to use (e.g. t1, t2, t3...)
+ * Gets next temporary variable ID to use (e.g. t1, t2, t3...), in constant time.
+ * Temporaries are numbered separately from variables, so cannot collide with them
  * @return next temp variable ID
  */
-std::string TAC_Generator::getNextID() {
-    std::string id = ("t" + std::to_string(tempIDNum++));
-
-    //Iterates through strings of instructions
-    auto it = find_if(instructions.begin(), instructions.end(), [&id](const Instruction& obj) {return obj.getResult() == id;});
-
-    //Makes sure that temp variable name is not duplicated
-    if (it != instructions.end())
-        return getNextID();
-
-    return id;
+Operand TAC_Generator::getNextID() {
+    return program.addTemp();
 }
 
 /**
  * Gets next label to prepend to instruction
  * @return next label
  */
-std::string TAC_Generator::getNextLabel() {
-    return std::string("L" + std::to_string(labelNum++));
+Operand TAC_Generator::getNextLabel() {
+    return program.addLabel();
 }
 
 /**
@@ -36,7 +27,7 @@ std::string TAC_Generator::getNextLabel() {
  */
 void TAC_Generator::generate(const std::shared_ptr<TreeNode> &parseTree) {
     //Adds start of program instruction
-    addInstruction("BeginProg", std::string(), std::string(), std::string());
+    addInstruction(Opcode::BEGIN_PROG, Operand(), Operand(), Operand());
     for (const std::shared_ptr<TreeNode> &node : parseTree->getChildren()) {
         //Validate Compound of global scope
         if (node->getLabel() == "Compound") {
@@ -44,7 +35,9 @@ void TAC_Generator::generate(const std::shared_ptr<TreeNode> &parseTree) {
         }
     }
     //End of program
-    addInstruction("EndProg", std::string(), std::string(), std::string());
+    addInstruction(Opcode::END_PROG, Operand(), Operand(), Operand());
+
+    resolveLabels();
 }
 
 /**
@@ -95,19 +88,19 @@ void TAC_Generator::statement(const std::shared_ptr<TreeNode> &parseTree) {
  * @param parseTree - to translate
  */
 void TAC_Generator::variable(const std::shared_ptr<TreeNode> &parseTree) {
-    std::string id;
+    Operand id;
 
     //Iterates through each symbol in the variable statement
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         //Stores ID
         if (node->getToken().getType() == Pattern::TokenType::ID) {
-            id = node->getToken().getValue();
+            id = program.addVariable(node->getSymbol());
         //If assignment
         } else if (node->getLabel() == "Variable Assignment") {
             for (const std::shared_ptr<TreeNode>& child : node->getChildren()) {
                 //Add assignment instruction with variable ID as result
                 if (child->getLabel() == "Expression") {
-                    addInstruction("ASSIGN", expression(child),  std::string(""), id);
+                    addInstruction(Opcode::ASSIGN, expression(child), Operand(), id);
                 }
             }
         }
@@ -120,8 +113,8 @@ void TAC_Generator::variable(const std::shared_ptr<TreeNode> &parseTree) {
  */
 void TAC_Generator::printStmt(const std::shared_ptr<TreeNode> &parseTree) {
     Token token = parseTree->getChildren().at(0)->getToken();
-    std::string temp;
-    std::string temp1;
+    Operand temp;
+    Operand temp1;
 
         switch (token.getType()) {
             //If print or println
@@ -133,25 +126,23 @@ void TAC_Generator::printStmt(const std::shared_ptr<TreeNode> &parseTree) {
                         //Store result of expression in temporary ID
                         temp = getNextID();
                         //Add instruction storing expression in temporary ID
-                        addInstruction("ASSIGN", expression(node), std::string(), temp);
+                        addInstruction(Opcode::ASSIGN, expression(node), Operand(), temp);
 
                         //If println
                         if (token.getType() == Pattern::TokenType::PRINTLN) {
                             temp1 = getNextID();
                             //Add instruction assigning newline to temporary variable
-                            addInstruction("ASSIGN", std::string(""), "\\n", temp1);
+                            addInstruction(Opcode::ASSIGN, Operand(), program.addString("\\n"), temp1);
                             //Push newline parameter when calling library function "_Print"
-                            addInstruction("PushParam", std::string(), temp1, std::string());
+                            addInstruction(Opcode::PUSH_PARAM, Operand(), temp1, Operand());
                         }
 
                         //Add instruction pushing value to print as parameter
-                        addInstruction("PushParam", std::string(), temp, std::string());
+                        addInstruction(Opcode::PUSH_PARAM, Operand(), temp, Operand());
                         //Add instruction calling _Print function
-                        addInstruction("Call", std::string(), "_Print", std::string());
-                        //Indicate branch instruction
-                        instructions.back().setBranchInstruction(true);
+                        addInstruction(Opcode::CALL, Operand(), program.addLibraryFunction("_Print"), Operand());
                         //Add instruciton popping params
-                        addInstruction("PopParams", std::string(), std::string(), std::string());
+                        addInstruction(Opcode::POP_PARAMS, Operand(), Operand(), Operand());
                     }
                 }
                 break;
@@ -161,16 +152,14 @@ void TAC_Generator::printStmt(const std::shared_ptr<TreeNode> &parseTree) {
                     switch (node->getToken().getType()) {
                         //Record ID
                         case Pattern::TokenType::ID:
-                            std::string id = node->getToken().getValue();
-                            std::string temp = getNextID();
+                            Operand id = program.addVariable(node->getSymbol());
+                            Operand temp = getNextID();
                             //Add instruction pushing temporary variable onto stack
-                            addInstruction("PushParam", std::string(), temp, std::string());
+                            addInstruction(Opcode::PUSH_PARAM, Operand(), temp, Operand());
                             //Add instruction calling _Readline function
-                            addInstruction("Call", std::string(), "_ReadLine", std::string());
-                            //Set as branching instruction
-                            instructions.back().setBranchInstruction(true);
+                            addInstruction(Opcode::CALL, Operand(), program.addLibraryFunction("_ReadLine"), Operand());
                             //Add instruction assigning result of _Readline (stored in temporary ID) to ID in get statement
-                            addInstruction("ASSIGN", std::string(), temp, id);
+                            addInstruction(Opcode::ASSIGN, Operand(), temp, id);
                             break;
                     }
                 }
@@ -186,35 +175,45 @@ void TAC_Generator::printStmt(const std::shared_ptr<TreeNode> &parseTree) {
  * @param parseTree - to translate
  */
 void TAC_Generator::ifStmt(const std::shared_ptr<TreeNode> &parseTree) {
-    std::string temp;
+    Operand temp;
+    //Label branched to if the condition is false, moved to the end of the else block if there is one
+    Operand end;
     //Identifies the correct part of the conditional statement generate code for
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         //Converts the condition expression to instructions
         if (node->getLabel() == "Expression") {
             temp = getNextID();
-            //Assigns result of conditional expression to temporary variable
-            addInstruction("ASSIGN", expression(node), std::string(), temp);
+            //Assigns result of conditional expression to temporary variable,
+            //branching to end of block early if a condition joined by 'and' is false
+            addInstruction(Opcode::ASSIGN, expression(node, &end), Operand(), temp);
 
             //Add instruction to branch to end of block if conditional exprssion is false
-            addInstruction("IfZ", temp, "Goto", "L" + std::to_string(getLabelNum()));
-            //Mark as branch instruction
-            instructions.back().setBranchInstruction(true);
+            if (end.empty()) end = getNextLabel();
+            addInstruction(Opcode::IFZ, temp, Operand(), end);
         } else if (node->getLabel() == "Compound") {
-            //Translate statements in block of if/else
+            //Translate statements in block of if
             scope(node);
-
-            //If in 'if' part of conditional,
-            if (parseTree->getLabel() == "If") {
-                //Require label to branch to end of if
-                setLabelRequired(true);
-                setBlockLabel(getNextLabel());
-            }
             //Converts the statements of else to instructions
         } else if (node->getLabel() == "Else") {
+            //Add instruction to skip over else block at end of if block
+            Operand skip = getNextLabel();
+            addInstruction(Opcode::GOTO, skip, Operand(), Operand());
+
+            //Else block begins with label branched to if condition is false
+            placeLabel(end);
+            end = skip;
+
             //Translate else block to three address code
-            ifStmt(node);
+            for (const std::shared_ptr<TreeNode>& child : node->getChildren()) {
+                if (child->getLabel() == "Compound") {
+                    scope(child);
+                }
+            }
         }
     }
+
+    //Require label to branch to end of if
+    placeLabel(end);
 }
 
 /**
@@ -222,33 +221,31 @@ void TAC_Generator::ifStmt(const std::shared_ptr<TreeNode> &parseTree) {
  * @param parseTree - to translate
  */
 void TAC_Generator::whileLoop(const std::shared_ptr<TreeNode> &parseTree) {
-    std::string temp;
-    std::string start;
+    Operand temp;
+    Operand start;
+    Operand end;
     //Identifies the correct part of the conditional statement generate code for
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         //Converts the conditional expression to instructions
         if (node->getLabel() == "Expression") {
-            setLabelRequired(true);
             start = getNextLabel();
-            setBlockLabel(start);
+            placeLabel(start);
 
             temp = getNextID();
-            //Adds instruction to store result of conditional expression
-            addInstruction("ASSIGN", expression(node), std::string(), temp);
+            //Adds instruction to store result of conditional expression,
+            //breaking out of loop early if a condition joined by 'and' is false
+            addInstruction(Opcode::ASSIGN, expression(node, &end), Operand(), temp);
 
             //Adds instruction to break out of loop if condition is false
-            addInstruction("IfZ", temp, "Goto", "L" + std::to_string(getLabelNum()));
-            //Marks as branching instruction
-            instructions.back().setBranchInstruction(true);
+            if (end.empty()) end = getNextLabel();
+            addInstruction(Opcode::IFZ, temp, Operand(), end);
         } else if (node->getLabel() == "Compound") {
             //Translate statements in body of while loop
             scope(node);
             //Adds instruction to goto start of loop
-            addInstruction("Goto", start, std::string(), std::string());
-            instructions.back().setBranchInstruction(true);
+            addInstruction(Opcode::GOTO, start, Operand(), Operand());
             //Next statement after loop requires matching label from earlier condition
-            setBlockLabel(getNextLabel());
-            setLabelRequired(true);
+            placeLabel(end);
         }
     }
 }
@@ -258,15 +255,15 @@ void TAC_Generator::whileLoop(const std::shared_ptr<TreeNode> &parseTree) {
  * @param parseTree
  */
 void TAC_Generator::assignment(const std::shared_ptr<TreeNode> &parseTree) {
-    std::string id;
+    Operand id;
 
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         if (node->getToken().getType() == Pattern::TokenType::ID) {
             //Stores the ID of the variable being assigned
-            id = node->getToken().getValue();
+            id = program.addVariable(node->getSymbol());
         } else if (node->getLabel() == "Expression") {
             //Adds an instruction which stores the result of the assignment expression
-            addInstruction("ASSIGN", expression(node), std::string(""), id);
+            addInstruction(Opcode::ASSIGN, expression(node), Operand(), id);
         }
     }
 }
@@ -276,28 +273,30 @@ void TAC_Generator::assignment(const std::shared_ptr<TreeNode> &parseTree) {
  * @param parseTree - to translate
  */
 void TAC_Generator::functionSig(const std::shared_ptr<TreeNode> &parseTree) {
-    std::string id;
+    //Function is not reached by falling through, so keeps any pending label for the statement after it
+    Operand label = getPendingLabel();
+    setPendingLabel(Operand());
 
     //iterate through each symbol in the function declaration
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         //Generate code for body of function
         if (node->getToken().getType() == Pattern::TokenType::ID) {
-            id = node->getToken().getValue();
-
-            //Sets value of next label
-            setBlockLabel(id);
-            //Next time instruction is added, label will be assigned
-            setLabelRequired(true);
+            //Next time instruction is added, function label will be assigned
+            placeLabel(program.addProcedure(node->getSymbol()));
 
             //Add instruction indicating beginning of function
-            addInstruction("BeginFunc", std::string(), std::string(), std::string());
+            addInstruction(Opcode::BEGIN_FUNC, Operand(), Operand(), Operand());
         //Translate instructions in function body
         } else if (node->getLabel() == "Compound") {
             scope(node);
         }
     }
     //Add instruction indicating end of function
-    addInstruction("EndFunc", std::string(), std::string(), std::string());
+    addInstruction(Opcode::END_FUNC, Operand(), Operand(), Operand());
+
+    if (!label.empty()) {
+        placeLabel(label);
+    }
 }
 
 /**
@@ -305,15 +304,15 @@ void TAC_Generator::functionSig(const std::shared_ptr<TreeNode> &parseTree) {
  * @param parseTree - to translate
  * @return temporary ID storing result of function call (if required by an expression)
  */
-std::string TAC_Generator::functionCall(const std::shared_ptr<TreeNode> &parseTree) {
-    std::string id;
-    std::stack<std::string> params;
+Operand TAC_Generator::functionCall(const std::shared_ptr<TreeNode> &parseTree) {
+    Operand id;
+    std::stack<Operand> params;
 
     //iterates through each symbol in the function call
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         if (node->getToken().getType() == Pattern::TokenType::ID) {
             //If the current token is the function identifier, store it
-            id = node->getToken().getValue();
+            id = program.addProcedure(node->getSymbol());
         //If the current node is an actual parameter
         } else if (node->getLabel() == "Actual Parameter") {
             for (const std::shared_ptr<TreeNode>& child : node->getChildren()) {
@@ -328,16 +327,16 @@ std::string TAC_Generator::functionCall(const std::shared_ptr<TreeNode> &parseTr
     //Until no more parameters
     while (!params.empty()) {
         //Push params in reverse order
-        addInstruction("PushParam", std::string(), params.top(), std::string());
+        addInstruction(Opcode::PUSH_PARAM, Operand(), params.top(), Operand());
         //Remove parameter from stack
         params.pop();
     }
 
-    std::string result = getNextID();
+    Operand result = getNextID();
     //Add instruction calling function, storing in temporary result variable
-    addInstruction("Call", std::string(), id, result);
+    addInstruction(Opcode::CALL, Operand(), id, result);
     //Add instruction popping parameters
-    addInstruction("PopParams", std::string(), std::string(), std::string());
+    addInstruction(Opcode::POP_PARAMS, Operand(), Operand(), Operand());
     //Return temporary variable storing result of call
     return result;
 }
@@ -349,38 +348,52 @@ std::string TAC_Generator::functionCall(const std::shared_ptr<TreeNode> &parseTr
 void TAC_Generator::returnStmt(const std::shared_ptr<TreeNode> &parseTree) {
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         if (node->getLabel() == "Expression") {
-            std::string temp = getNextID();
-            addInstruction("Return", std::string(), expression(node), std::string());
+            addInstruction(Opcode::RETURN, Operand(), expression(node), Operand());
         }
     }
 }
 
 /**
- * Recursively Translates the current expression into three address code
+ * Recursively Translates the current expression into three address code. The right operand of 'and' and 'or'
+ * is only evaluated if the left operand does not decide the result. In a condition, an 'and' which is the last
+ * operation of the expression branches to the label taken when the condition is false as soon as its left
+ * operand is false, rather than storing the result
  * @param parseTree - to translate
- * @return temporary variable storing result of expression or literal value
+ * @param falseLabel - label branched to if the condition is false, created when first needed
+ * (nullptr if the expression is not a condition)
+ * @return temporary variable storing result of expression or literal value (in a condition, the result given
+ * that no branch was taken)
  */
-std::string TAC_Generator::expression(const std::shared_ptr<TreeNode>& parseTree) {
+Operand TAC_Generator::expression(const std::shared_ptr<TreeNode>& parseTree, Operand* falseLabel) {
     //Instruction quadruple
-    std::string op;
-    std::string arg1;
-    std::string arg2;
-    std::string result;
+    Opcode op = Opcode::ASSIGN;
+    Operand arg1;
+    Operand arg2;
+    Operand result;
+
+    //Uses the value folded during type checking if known at compile time
+    if (parseTree->isConstant()) {
+        return constant(parseTree);
+    }
 
     //Iterates through each symbol in the expression
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         switch (node->getToken().getType()) {
             //Identifies terminals/ID/function call as arg1
             case Pattern::TokenType::ID:
+                arg1 = program.addVariable(node->getSymbol());
+                break;
             case Pattern::TokenType::NUM:
+                arg1 = Operand::integer(std::stol(node->getToken().getValue()));
+                break;
             case Pattern::TokenType::STRING_LITERAL:
-                arg1 = node->getToken().getValue();
+                arg1 = program.addString(node->getToken().getValue());
                 break;
             case Pattern::TokenType::TRUE:
-                arg1 = "true";
+                arg1 = Operand::boolean(true);
                 break;
             case Pattern::TokenType::FALSE:
-                arg1 = "false";
+                arg1 = Operand::boolean(false);
                 break;
             default:
                 if (node->getLabel() == "Function Call") {
@@ -388,10 +401,10 @@ std::string TAC_Generator::expression(const std::shared_ptr<TreeNode>& parseTree
                     break;
                 }
 
-                //Records intermediary operation
-                if (!arg1.empty() && !arg2.empty()) {
+                //Records intermediary operation (with no first argument if 'not')
+                if (!arg2.empty()) {
                     arg1 = addInstruction(op, arg1, arg2, result);
-                    arg2 = "";
+                    arg2 = Operand();
                 }
 
                 //If bracketed expression, set result of inner expression as first argument
@@ -399,20 +412,19 @@ std::string TAC_Generator::expression(const std::shared_ptr<TreeNode>& parseTree
                     arg1 = expression(node);
 
                 //Otherwise if an operation
-                } else if (isOperation(node->getLabel())) {
+                } else if (node->getOperator() != Pattern::TokenType::NONE) {
                     //Get operator token
-                    op = node->getLabel();
-
-                    //Check if bracketed expression within operation and set as second parameter
-                    for (const std::shared_ptr<TreeNode>& child : node->getChildren()) {
-                        if (child->getLabel() == "Expression") {
-                            arg2 = expression(child);
-                        }
-                    }
-
-                    //Otherwise if expression is of equal precedence (not in brackets)
-                    //process as normal
-                    if (arg2.empty()) {
+                    op = Opcodes::fromOperator(node->getOperator());
+
+                    if (op == Opcode::AND && falseLabel != nullptr && node == parseTree->getChildren().back()) {
+                        //Branch as soon as the left operand of the last 'and' of a condition is false
+                        if (falseLabel->empty()) *falseLabel = getNextLabel();
+                        addInstruction(Opcode::IFZ, arg1, Operand(), *falseLabel);
+                        arg1 = expression(node, falseLabel);
+                    } else if (op == Opcode::AND || op == Opcode::OR) {
+                        arg1 = shortCircuit(op, arg1, node);
+                    } else {
+                        //Translate subexpression of operator (including any bracketed expressions) as second parameter
                         arg2 = expression(node);
                     }
                 }
@@ -428,6 +440,42 @@ std::string TAC_Generator::expression(const std::shared_ptr<TreeNode>& parseTree
     }
 }
 
+/**
+ * Translates 'and' or 'or' so that its right operand is only evaluated if its left operand does not decide the
+ * result: the result is assigned the left operand, and then the right operand unless the left was false for 'and'
+ * or true for 'or'
+ * @param op - AND or OR
+ * @param left - result of left operand
+ * @param parseTree - operation whose subexpression is the right operand
+ * @return temporary variable storing result of operation
+ */
+Operand TAC_Generator::shortCircuit(Opcode op, const Operand &left, const std::shared_ptr<TreeNode> &parseTree) {
+    Operand result = getNextID();
+    Operand end = getNextLabel();
+    addInstruction(Opcode::ASSIGN, left, Operand(), result);
+
+    //Skips the right operand if the left is false for 'and', or if its negation is false for 'or'
+    Operand test = (op == Opcode::AND) ? result : addInstruction(Opcode::NOT, Operand(), result, Operand());
+    addInstruction(Opcode::IFZ, test, Operand(), end);
+
+    addInstruction(Opcode::ASSIGN, expression(parseTree), Operand(), result);
+    placeLabel(end);
+    return result;
+}
+
+/**
+ * Gets the literal of a value folded during type checking
+ * @param parseTree - constant expression
+ * @return literal of value
+ */
+Operand TAC_Generator::constant(const std::shared_ptr<TreeNode> &parseTree) {
+    if (parseTree->getType() == Type::BOOL) {
+        return Operand::boolean(parseTree->getConstantValue() != 0);
+    }
+
+    return Operand::integer(parseTree->getConstantValue());
+}
+
 /**
  * Adds an instruction to the list of instructions
  * @param op - operation of instruction
@@ -436,8 +484,8 @@ std::string TAC_Generator::expression(const std::shared_ptr<TreeNode>& parseTree
  * @param result - result of instruction
  * @return resulting ID of instruction
  */
-std::string TAC_Generator::addInstruction(std::string op, std::string arg1, std::string arg2, std::string result) {
-    if (result.empty() && isOperation(op)) {
+Operand TAC_Generator::addInstruction(Opcode op, Operand arg1, Operand arg2, Operand result) {
+    if (result.empty() && Opcodes::isOperation(op)) {
         //Generate new temporary variable ID e.g. t1, t2, t3...
         result = getNextID();
     }
@@ -446,139 +494,73 @@ std::string TAC_Generator::addInstruction(std::string op, std::string arg1, std:
     Instruction instruction(op, arg1, arg2, result);
 
     //Set label if block
-    if (isLabelRequired()) {
-        instruction.setLabel(getBlockLabel());
-        setLabelRequired(false);
+    if (!getPendingLabel().empty()) {
+        instruction.setLabel(getPendingLabel().getValue());
+        setPendingLabel(Operand());
     }
 
     //Add instruction to queue
-    instructions.emplace_back(instruction);
+    program.addInstruction(instruction);
 
     //Return result ID
     return result;
 }
 
 /**
- * returns whether a given parse tree label is an operation (e.g. relational or arithmetic)
- * @param label - to check
- * @return whether label is operation
- */
-bool TAC_Generator::isOperation(const std::string& label) {
-    return (Semantic::labelToToken.find(label) != Semantic::labelToToken.end());
-}
-
-/**
- * Prints the list of instructions
+ * Prepends a label to the next added instruction. If another label is already
+ * waiting for that instruction, branches to the given label are later redirected to it
+ * @param label - to prepend
  */
-void TAC_Generator::printInstructions() {
-    std::cout << "Three Address Code Generation:" << std::endl;
-    std::cout << "------------------------------------------------------------------" << std::endl;
-
-    //Print each three address code instruction in program
-    for (const Instruction& instruction : instructions) {
-            printInstruction(instruction);
+void TAC_Generator::placeLabel(const Operand &label) {
+    if (getPendingLabel().empty()) {
+        setPendingLabel(label);
+    } else {
+        aliases[label.getValue()] = getPendingLabel().getValue();
     }
 }
 
 /**
- * Prints given instruction
- * @param instruction - to print
+ * Replaces each branch to a label which was placed alongside another label with a branch to that label
  */
-void TAC_Generator::printInstruction(Instruction instruction) {
-    std::string instructionStr;
-
-    //If conditional instruction, simply print the values not as an assignment
-    if (instruction.isBranchInstruction()) {
-        instructionStr += "\t " + instruction.getOp() + " ";
-        instructionStr += instruction.getArg1() + " ";
-        instructionStr += instruction.getArg2() + " ";
-        instructionStr += instruction.getResult() + " ";
-        std::cout << instructionStr << ";" << std::endl;
-        return;
-    }
-
-    //Otherwise generate string to print:
-
-    //If instruction has a result
-    if (!instruction.getResult().empty()) {
-        //Add equals sign
-        instructionStr += instruction.getResult() + " = ";
-    }
-
-    //Add first argument if one is present
-    if (!instruction.getArg1().empty()) {
-        instructionStr += instruction.getArg1() + " ";
-    }
-
-    //If not assignment
-    if (instruction.getOp() != "ASSIGN") {
-        //If operation of instruction is arithmetic/logical/relational
-        if (isOperation(instruction.getOp())) {
-            //Get symbol using operation token
-            instructionStr += Lexer::TOKEN_STRINGS[static_cast<unsigned long>(Semantic::labelToToken.at(instruction.getOp()))];
-        } else {
-            //Otherwise simply append the operation string (e.g. being, end, PushParam etc)
-            instructionStr += instruction.getOp() + " ";
+void TAC_Generator::resolveLabels() {
+    if (aliases.empty()) return;
+
+    for (Instruction& instruction : program.getInstructions()) {
+        if (instruction.getOp() == Opcode::IFZ && aliases.count(instruction.getResult().getValue())) {
+            instruction.setResult(Operand(OperandKind::LABEL, aliases[instruction.getResult().getValue()]));
+        } else if (instruction.getOp() == Opcode::GOTO && aliases.count(instruction.getArg1().getValue())) {
+            instruction.setArg1(Operand(OperandKind::LABEL, aliases[instruction.getArg1().getValue()]));
         }
-
     }
-
-    //Append second argument (if only one argument is present second one is)
-    instructionStr += " " + instruction.getArg2() + ";";
-
-    //Print label prepending instruction if not empty
-    std::string temp = instructionStr;
-    instructionStr = (!instruction.getLabel().empty()) ? instruction.getLabel() + ": " : "\t ";
-    instructionStr += temp;
-
-    //Print instruction string
-    std::cout << " " + instructionStr << std::endl;
-}
-
-/**
- * Returns whether current instruction needs a label prepended
- * @return labelRequired
- */
-bool TAC_Generator::isLabelRequired() const {
-    return labelRequired;
-}
-
-/**
- * Setter for labelRequired
- * @param labelRequired
- */
-void TAC_Generator::setLabelRequired(bool labelRequired) {
-    TAC_Generator::labelRequired = labelRequired;
 }
 
 /**
- * Getter for number of labels in instructions
- * @return number of next label
+ * Prints the list of instructions
  */
-unsigned long TAC_Generator::getLabelNum() const {
-    return labelNum;
+void TAC_Generator::printInstructions() {
+    program.print();
 }
 
 /**
- * Getter for blockLabel
- * @return value of label to be prepended
+ * Getter for pendingLabel
+ * @return label to prepend to the next instruction (empty if none)
  */
-const std::string &TAC_Generator::getBlockLabel() const {
-    return blockLabel;
+const Operand &TAC_Generator::getPendingLabel() const {
+    return pendingLabel;
 }
 
 /**
- * Setter for blockLabel
- * @param blockLabel - to assign
+ * Setter for pendingLabel
+ * @param pendingLabel - to assign
  */
-void TAC_Generator::setBlockLabel(const std::string &blockLabel) {
-    TAC_Generator::blockLabel = blockLabel;
+void TAC_Generator::setPendingLabel(const Operand &pendingLabel) {
+    TAC_Generator::pendingLabel = pendingLabel;
 }
 
 /**
- * Getter for list of instructions
- * @return instructions - list of instructions
+ * Getter for generated program
+ * @return program - list of instructions and the tables their operands index into
  */
-const std::vector<Instruction> &TAC_Generator::getInstructions() const {
-    return instructions;
+const Program &TAC_Generator::getProgram() const {
+    return program;
 }
@@ -3,8 +3,8 @@
 #include <vector>
 #include <algorithm>
 #include <string>
-#include <map>
-#include "Instruction.h"
+#include <unordered_map>
+#include "Program.h"
 #include "../parser/TreeNode.h"
 
 /**
@@ -13,23 +13,18 @@
  */
 class TAC_Generator {
 private:
-    //Stores list of generated three address code instructions
-    std::vector<Instruction> instructions;
+    //Stores the generated program of three address code instructions
+    Program program;
 public:
-    //Getter for list of instructions
-    const std::vector<Instruction> &getInstructions() const;
+    //Getter for generated program
+    const Program &getProgram() const;
 
 private:
+    //Label to prepend to the next added instruction (empty if none)
+    Operand pendingLabel;
 
-    //Stores number of temporary variable names (counts from 1, as in the example file)
-    unsigned long tempIDNum = 1;
-    //Stores number of conditional labels (counts from 0, as in the example file)
-    unsigned long labelNum = 0;
-
-    //Indicates whether the next added instruction requires a label
-    bool labelRequired = false;
-    //Stores label to add to instruction
-    std::string blockLabel;
+    //Maps labels placed on an instruction which already had a label to that label
+    std::unordered_map<uint32_t, uint32_t> aliases;
 
     //Translates the current scope into three address code
     void scope(const std::shared_ptr<TreeNode>& parseTree);
@@ -56,29 +51,35 @@ private:
     void functionSig(const std::shared_ptr<TreeNode>& parseTree);
 
     //Translates the current function into three address code
-    std::string functionCall(const std::shared_ptr<TreeNode>& parseTree);
+    Operand functionCall(const std::shared_ptr<TreeNode>& parseTree);
 
     //Translates the current return statement into three address code
     void returnStmt(const std::shared_ptr<TreeNode>& parseTree);
 
-    //Translates the current expression into three address code
-    std::string expression(const std::shared_ptr<TreeNode>& parseTree);
+    //Translates the current expression into three address code, branching to falseLabel early if a condition
+    Operand expression(const std::shared_ptr<TreeNode>& parseTree, Operand* falseLabel = nullptr);
+
+    //Translates 'and' or 'or' so that its right operand is only evaluated if needed
+    Operand shortCircuit(Opcode op, const Operand& left, const std::shared_ptr<TreeNode>& parseTree);
 
-    //returns whether a given label is an operation (e.g. relational or arithmetic)
-    static bool isOperation(const std::string& label);
+    //Gets the literal of an expression folded during type checking
+    static Operand constant(const std::shared_ptr<TreeNode>& parseTree);
 
     //Adds an instruction to the list of instructions given a quadruple
-    std::string addInstruction(std::string op, std::string arg1, std::string arg2, std::string result);
+    Operand addInstruction(Opcode op, Operand arg1, Operand arg2, Operand result);
 
-    //Prints a given instruction
-    void printInstruction(Instruction instruction);
+    //Prepends a label to the next added instruction
+    void placeLabel(const Operand& label);
+
+    //Replaces each branch to a label which was placed with another with a branch to that label
+    void resolveLabels();
 
 public:
     //Getter for next temporary ID value
-    std::string getNextID();
+    Operand getNextID();
 
     //Getter for next label value
-    std::string getNextLabel();
+    Operand getNextLabel();
 
     //Generates a list of three address code instructions from a given parse tree
     void generate(const std::shared_ptr<TreeNode>& parseTree);
@@ -86,19 +87,9 @@ public:
     //Prints the list of instructions
     void printInstructions();
 
-    //Returns whether current instruction needs a label prepended
-    bool isLabelRequired() const;
-
-    //Getter the number for the next label to add
-    unsigned long getLabelNum() const;
-
-    //Sets whether the next instruction requires a label prepended
-    void setLabelRequired(bool labelRequired);
-
-    //Gets value of next label to prepend
-    const std::string &getBlockLabel() const;
-
-    //Sets value of next label to prepend
-    void setBlockLabel(const std::string &blockLabel);
+    //Getter for label to prepend to the next instruction
+    const Operand &getPendingLabel() const;
 
+    //Setter for label to prepend to the next instruction
+    void setPendingLabel(const Operand &pendingLabel);
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include "../semantic/Scope.h"
 
 /**
@@ -9,21 +10,92 @@
 class Operator {
 private:
     //Operands required by operator
-    std::pair<Type, Type> operands;
-    //Output of operator
+    Type first;
+    Type second;
+    //Output of operator (NONE if not an operator)
     Type output;
 public:
     //Constructor
-    Operator(const std::pair<Type, Type> &operands, Type output);
+    constexpr Operator(const std::pair<Type, Type> &operands, Type output) : first(operands.first),
+                                                                          second(operands.second),
+                                                                          output(output)
+    {
+    }
 
-    //Default constructor
-    Operator() = default;
+    //Default constructor, for token types which are not operators
+    constexpr Operator() : first(Type::NONE), second(Type::NONE), output(Type::NONE)
+    {
+    }
 
     //Getter for operands
-    const std::pair<Type, Type> &getOperands() const;
+    constexpr std::pair<Type, Type> getOperands() const {
+        return {first, second};
+    }
 
     //Getter for output
-    Type getOutput() const;
+    constexpr Type getOutput() const {
+        return output;
+    }
 };
 
+/**
+ * Tables of the permitted operators, built at compile time and indexed by token type,
+ * so that checking an operator is a single array load rather than map lookups
+ */
+namespace Operators {
+    //Gets the index of a token type or type in a table
+    template <typename T>
+    constexpr unsigned long index(T value) {
+        return static_cast<unsigned long>(value);
+    }
+
+    //Builds the list of permitted operators, their operands, and resulting types
+    constexpr std::array<Operator, Pattern::TOKEN_TYPES> makeOperators() {
+        std::array<Operator, Pattern::TOKEN_TYPES> table {};
+
+        table[index(Pattern::TokenType::PLUS)] = Operator({Type::INT, Type::INT}, Type::INT);
+        table[index(Pattern::TokenType::MINUS)] = Operator({Type::INT, Type::INT}, Type::INT);
+        table[index(Pattern::TokenType::MULTIPLY)] = Operator({Type::INT, Type::INT}, Type::INT);
+        table[index(Pattern::TokenType::DIVIDE)] = Operator({Type::INT, Type::INT}, Type::INT);
+        table[index(Pattern::TokenType::AND)] = Operator({Type::BOOL, Type::BOOL}, Type::BOOL);
+        table[index(Pattern::TokenType::OR)] = Operator({Type::BOOL, Type::BOOL}, Type::BOOL);
+        table[index(Pattern::TokenType::LT)] = Operator({Type::INT, Type::INT}, Type::BOOL);
+        table[index(Pattern::TokenType::GT)] = Operator({Type::INT, Type::INT}, Type::BOOL);
+        table[index(Pattern::TokenType::LTE)] = Operator({Type::INT, Type::INT}, Type::BOOL);
+        table[index(Pattern::TokenType::GTE)] = Operator({Type::INT, Type::INT}, Type::BOOL);
+        table[index(Pattern::TokenType::EQ)] = Operator({Type::INT, Type::INT}, Type::BOOL);
+        table[index(Pattern::TokenType::NOT)] = Operator({Type::NONE, Type::BOOL}, Type::BOOL);
+
+        return table;
+    }
+
+    //List of permitted operators, their operands, and resulting types, indexed by token type
+    inline constexpr std::array<Operator, Pattern::TOKEN_TYPES> OPERATORS = makeOperators();
+
+    //Result type of each operator for each pair of operand types (NONE if invalid)
+    using ResultTable = std::array<std::array<std::array<Type, TYPES>, TYPES>, Pattern::TOKEN_TYPES>;
+
+    //Builds the result type of each operator for every pair of operand types from the list of operators
+    constexpr ResultTable makeResults() {
+        ResultTable table {};
+
+        for (unsigned long op = 0; op < Pattern::TOKEN_TYPES; op++) {
+            for (unsigned long first = 0; first < TYPES; first++) {
+                for (unsigned long second = 0; second < TYPES; second++) {
+                    table[op][first][second] = Type::NONE;
+                }
+            }
+
+            //Only the exact operand types of an operator are valid
+            if (OPERATORS[op].getOutput() != Type::NONE) {
+                std::pair<Type, Type> operands = OPERATORS[op].getOperands();
+                table[op][index(operands.first)][index(operands.second)] = OPERATORS[op].getOutput();
+            }
+        }
+
+        return table;
+    }
 
+    //Result type of each operator for each pair of operand types, indexed by [operator][first][second]
+    inline constexpr ResultTable RESULTS = makeResults();
+}
@@ -1,6 +1,16 @@
+#include <limits>
 #include "TypeChecker.h"
 #include "TypeException.h"
 #include "../parser/Lexer.h"
+#include "../semantic/Parallel.h"
+
+/**
+ * Constructor for TypeChecker
+ * @param jobs - number of threads used to check the bodies of top-level procedures
+ */
+TypeChecker::TypeChecker(unsigned int jobs) : jobs(jobs)
+{
+}
 
 /**
  * Validate the types of a given parse tree
@@ -9,14 +19,17 @@
  */
 void TypeChecker::checkTypes(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<Scope>& global) {
     try {
-        std::cout << "Type Checking:" << std::endl;
-        std::cout << "------------------------------------------------------------------" << std::endl;
+        printHeader();
 
         //Iterates through each scope to check
         for (const std::shared_ptr<TreeNode> &node : parseTree->getChildren()) {
             //Validate Compound of global scope
             if (node->getLabel() == "Compound") {
-                validateScopeTypes(node, global);
+                if (jobs > 1) {
+                    validateGlobalScopeTypes(node, global);
+                } else {
+                    validateScopeTypes(node, global);
+                }
             }
         }
 
@@ -24,10 +37,101 @@ void TypeChecker::checkTypes(const std::shared_ptr<TreeNode> &parseTree, const s
         std::cout << "No type errors" << std::endl << std::endl;
     //Exception thrown if error occurs
     } catch (TypeException& e) {
+        std::cout << e.what() << std::endl;
         exit(4);
     }
 }
 
+/**
+ * Type checks a single statement during a fused pass with semantic analysis,
+ * recording the first type error rather than exiting so that any later
+ * semantic error is still reported first, as with separate phases
+ * @param parseTree - statement to check, whose identifiers have been resolved
+ * @param scope - to lookup symbols in
+ */
+void TypeChecker::checkStatement(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<Scope> &scope) {
+    //Only the first type error is reported
+    if (!firstError.empty()) return;
+
+    try {
+        std::string label = parseTree->getLabel();
+
+        //Bodies of conditionals and functions are checked statement by statement as they are analysed,
+        //so only statements without inner blocks are checked here
+        if (label == "Variable") {
+            variable(parseTree, scope);
+        } else if (label == "Print Statement") {
+            printStmt(parseTree, scope);
+        } else if (label == "Assignment") {
+            assignment(parseTree, scope);
+        } else if (label == "Function Call") {
+            functionCall(parseTree, scope);
+        } else if (label == "Return Statement") {
+            returnStmt(parseTree, scope);
+        }
+    } catch (TypeException& e) {
+        firstError = e.what();
+    }
+}
+
+/**
+ * Type checks the condition of an if or while statement during a fused pass,
+ * recording the first type error rather than exiting
+ * @param parseTree - conditional statement whose condition is checked
+ * @param condition - expression of the condition
+ * @param scope - to lookup symbols in
+ */
+void TypeChecker::checkCondition(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<TreeNode> &condition,
+                                 const std::shared_ptr<Scope> &scope) {
+    if (!firstError.empty()) return;
+
+    try {
+        expression(condition, scope, Type::BOOL, parseTree->getChildren()[0]->getToken().getLineNum());
+    } catch (TypeException& e) {
+        firstError = e.what();
+    }
+}
+
+/**
+ * Reports the result of a fused pass in the same form as checkTypes,
+ * exiting if a type error was recorded
+ */
+void TypeChecker::report() {
+    printHeader();
+
+    if (!firstError.empty()) {
+        std::cout << firstError << std::endl;
+        exit(4);
+    }
+
+    std::cout << "No type errors" << std::endl << std::endl;
+}
+
+/**
+ * Getter for first type error found during a fused pass
+ * @return error message, empty if none
+ */
+const std::string &TypeChecker::getError() const {
+    return firstError;
+}
+
+/**
+ * Setter for first type error found during a fused pass,
+ * used to merge the errors of procedure bodies checked in parallel
+ * @param error - message of error
+ */
+void TypeChecker::setError(const std::string &error) {
+    firstError = error;
+}
+
+/**
+ * Prints the heading of the type checking output
+ */
+void TypeChecker::printHeader() {
+    std::cout << "Type Checking:" << std::endl;
+    std::cout << "------------------------------------------------------------------" << std::endl;
+}
+
 /**
  * Validates types of current scope
  * @param parseTree - to check
@@ -42,6 +146,61 @@ void TypeChecker::validateScopeTypes(const std::shared_ptr<TreeNode> &parseTree,
     }
 }
 
+/**
+ * Validates types of the global scope in two phases. First the global statements are checked in order,
+ * deferring the bodies of top-level procedures. Then the bodies, which only read the scope tree and
+ * symbols annotated during semantic analysis, are checked in parallel. Errors are merged by position
+ * in the source, so that the same error is reported as when checking in order.
+ * @param parseTree - compound of global scope
+ * @param global - scope to lookup symbols in
+ */
+void TypeChecker::validateGlobalScopeTypes(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<Scope> &global) {
+    //Position of first error, with no error ordered after every statement
+    std::string error;
+    unsigned long errorSequence = std::numeric_limits<unsigned long>::max();
+
+    //Checks global statements in order until the first error
+    try {
+        for (sequence = 0; sequence < parseTree->getChildren().size(); sequence++) {
+            const std::shared_ptr<TreeNode>& node = parseTree->getChildren()[sequence];
+
+            if (node->getLabel() == "Statement") {
+                statement(node, global);
+            }
+        }
+    } catch (TypeException& e) {
+        error = e.what();
+        errorSequence = sequence;
+    }
+
+    //Bodies after the first error cannot change which error is reported
+    while (!bodies.empty() && bodies.back().sequence > errorSequence) {
+        bodies.pop_back();
+    }
+
+    Parallel::forEach(bodies.size(), jobs, [this](unsigned long i) {
+        try {
+            functionSig(bodies[i].signature);
+        } catch (TypeException& e) {
+            bodies[i].error = e.what();
+        }
+    });
+
+    //Bodies are in source order, so the first with an error precedes any error in a later global statement
+    for (const ProcedureBody& body : bodies) {
+        if (!body.error.empty()) {
+            error = body.error;
+            break;
+        }
+    }
+
+    bodies.clear();
+
+    if (!error.empty()) {
+        throw TypeException(error);
+    }
+}
+
 /**
  * Validates the types of the current statement
  * @param parseTree - to check
@@ -62,7 +221,12 @@ void TypeChecker::statement(const std::shared_ptr<TreeNode> &parseTree, const st
         } else if (label == "Assignment") {
             assignment(node, scope);
         } else if (label == "Function Signature") {
-            functionSig(node, scope);
+            //Defers the body of a top-level procedure when checking bodies in parallel
+            if (jobs > 1 && scope->isGlobal()) {
+                bodies.push_back({sequence, node, ""});
+            } else {
+                functionSig(node);
+            }
         } else if (label == "Function Call") {
             functionCall(node, scope);
         } else if (label == "Return Statement") {
@@ -77,7 +241,6 @@ void TypeChecker::statement(const std::shared_ptr<TreeNode> &parseTree, const st
  * @param scope - to lookup symbols in
  */
 void TypeChecker::variable(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<Scope>& scope) {
-    std::string id;
     Token token = parseTree->getToken();
     Type type = Type::INT;
     bool isAssignment = false;
@@ -98,8 +261,7 @@ void TypeChecker::variable(const std::shared_ptr<TreeNode> &parseTree, const std
         //Stores type and ID of variable
         switch (node->getToken().getType()) {
             case Pattern::TokenType::ID:
-                id = node->getToken().getValue();
-                type = scope->getSymbolTable().at(id).second;
+                type = node->getSymbol()->getType();
                 break;
             default:
                 break;
@@ -146,7 +308,7 @@ void TypeChecker::printStmt(const std::shared_ptr<TreeNode> &parseTree, const st
             for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
                 if (node->getToken().getType() == Pattern::TokenType::ID) {
                     //Ensures that get takes a string argument
-                    if ((type = scope->getSymbol(node->getToken().getValue(), scope).second) != Type::STRING) {
+                    if ((type = node->getSymbol()->getType()) != Type::STRING) {
 
                         //Throws an error if get is given a bool or int
                         std::string err = "Error: 'get' statement on line ";
@@ -165,8 +327,7 @@ void TypeChecker::printStmt(const std::shared_ptr<TreeNode> &parseTree, const st
                             default:
                                 break;
                         }
-                        std::cout << err << std::endl;
-                        throw TypeException(nullptr);
+                        throw TypeException(err);
                     }
                 }
             }
@@ -189,10 +350,9 @@ void TypeChecker::conditionalStmt(const std::shared_ptr<TreeNode> &parseTree, co
         if (node->getLabel() == "Expression") {
             expression(node, scope, Type::BOOL, line);
 
-        //Validates body of conditional statement
+        //Validates body of conditional statement in the scope opened for it
         } else if (node->getLabel() == "Compound") {
-            validateScopeTypes(node, scope->getScopes().at(scope->getCurrent()));
-            scope->setCurrent(scope->getCurrent() + 1);
+            validateScopeTypes(node, node->getScope());
 
         //Validates else of an if
         } else if (node->getLabel() == "Else") {
@@ -215,7 +375,7 @@ void TypeChecker::assignment(const std::shared_ptr<TreeNode> &parseTree, const s
         //If symbol is ID
         if (node->getToken().getType() == Pattern::TokenType::ID) {
             //Record type of variable being assigned
-            expected = scope->getSymbol(node->getToken().getValue(), scope).second;
+            expected = node->getSymbol()->getType();
             //Record line number of assignment
             line = node->getToken().getLineNum();
         } else if (node->getLabel() == "Expression") {
@@ -226,21 +386,15 @@ void TypeChecker::assignment(const std::shared_ptr<TreeNode> &parseTree, const s
 }
 
 /**
- * Validates a function signature
+ * Validates a function signature, checking its body in the scope of the body
  * @param parseTree - to check
- * @param scope - to lookup symbols in
  */
-void TypeChecker::functionSig(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<Scope> &scope) {
+void TypeChecker::functionSig(const std::shared_ptr<TreeNode> &parseTree) {
     //iterate through each symbol in the function declaration
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
-        //Validate body of function
+        //Validate body of function in function scope
         if (node->getLabel() == "Compound") {
-            //Records current scope as parent
-            std::shared_ptr<Scope> child = scope->getScopes().at(scope->getCurrent());
-            child->setParent(scope);
-            //Validate function scope
-            validateScopeTypes(node, child);
-            scope->setCurrent(scope->getCurrent() + 1);
+            validateScopeTypes(node, node->getScope());
         }
     }
 }
@@ -262,9 +416,6 @@ Type TypeChecker::functionCall(const std::shared_ptr<TreeNode> &parseTree, const
     std::vector<Type> actualParams;
     std::vector<Type> formalParams;
 
-    //Stores identifiers of function called
-    std::vector<std::pair<std::string, std::pair<Object, Type>>> functionIDs;
-
     //iterates through each symbol in the function call
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
         switch (node->getToken().getType()) {
@@ -274,20 +425,11 @@ Type TypeChecker::functionCall(const std::shared_ptr<TreeNode> &parseTree, const
                 line = node->getToken().getLineNum();
                 //Records name of function
                 funcID = node->getToken().getValue();
-                //Gets variables in scope of function declaration
-                functionIDs = scope->getFuncIDs(funcID, scope);
-
                 //Records formal parameter types
-                for (const std::pair<std::string, std::pair<Object, Type>> entry : functionIDs) {
-                    if (entry.second.first == Object::PARAM) {
-                        formalParams.emplace_back(entry.second.second);
-                    } else {
-                        break;
-                    }
-                }
+                formalParams = node->getSymbol()->getParameters();
 
                 //Gets return type of function
-                retType = scope->getSymbol(node->getToken().getValue(), scope).second;
+                retType = node->getSymbol()->getType();
                 break;
             default:
                 break;
@@ -331,7 +473,7 @@ Type TypeChecker::functionCall(const std::shared_ptr<TreeNode> &parseTree, const
  * @param scope - to lookup symbols in
  */
 void TypeChecker::returnStmt(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<Scope> &scope) {
-    Type returnType = scope->getReturnType(scope);
+    Type returnType = scope->getReturnType();
     unsigned long line = parseTree->getChildren()[0]->getToken().getLineNum();
 
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
@@ -360,17 +502,21 @@ void TypeChecker::expression(const std::shared_ptr<TreeNode> &parseTree, const s
 
 /**
  * Evaluates an expression and returns the resulting type
- * if all operators are provided the correct operands
+ * if all operators are provided the correct operands.
+ * Children are folded from left to right, visiting each node once: an operand becomes the first operand,
+ * and an operator node's children are evaluated as its second operand before applying the operator.
+ * Int and bool values which are known at compile time are folded alongside their types.
+ * The type and any constant value of each expression and function call node are recorded on the node,
+ * and for an operator node those of the subexpression it contains.
  * @param parseTree - to type check
  * @param scope - to find the type of symbols
  * @param line - to print if an error occurs
  */
 Type TypeChecker::evaluateExpression(const std::shared_ptr<TreeNode> &parseTree, const std::shared_ptr<Scope>& scope, unsigned long line) {
     Type op1 = Type::NONE;
-    Type op2 = Type::NONE;
-    std::string id;
-    Operator myOperator;
-    Pattern::TokenType type;
+    //Whether first operand is known at compile time, and its value if so
+    bool constant = false;
+    long value = 0;
 
     //Iterates through the children of the current expression
     for (const std::shared_ptr<TreeNode>& node : parseTree->getChildren()) {
@@ -378,53 +524,138 @@ Type TypeChecker::evaluateExpression(const std::shared_ptr<TreeNode> &parseTree,
 
         //Identifies the first operand of the current expression if something other than the 'not' expression
         if (temp == Pattern::TokenType::ID) {
-            id = node->getToken().getValue();
-            op1 = scope->getSymbol(id, scope).second;
+            op1 = node->getSymbol()->getType();
+            constant = false;
         } else if (temp == Pattern::TokenType::TRUE || temp == Pattern::TokenType::FALSE) {
             op1 = Type::BOOL;
+            constant = true;
+            value = (temp == Pattern::TokenType::TRUE);
         } else if (temp == Pattern::TokenType::STRING_LITERAL) {
             op1 = Type::STRING;
+            constant = false;
         } else if (temp == Pattern::TokenType::NUM) {
             op1 = Type::INT;
-        //Identifies subexpression as second operand in the case of a bracketed expression
+            constant = true;
+            value = evaluateLiteral(node->getToken());
         } else if (node->getLabel() == "Function Call") {
             op1 = functionCall(node, scope);
+            constant = false;
+            node->setType(op1);
+        //Identifies a bracketed subexpression as the first operand
         } else if (node->getLabel() == "Expression") {
-            //Expression directly contains expression, return subexpression evaluation as result
-            return evaluateExpression(node, scope, line);
-        //Identifies a subexpression as second operand in the case of an operator
-        } else if (Semantic::labelToToken.find(node->getLabel()) != Semantic::labelToToken.end()) {
-            //records type of expression for error handling
-            type = Semantic::labelToToken.at(node->getLabel());
-
-            //Gets the operator information associated with the current expression label
-            myOperator = operators.at(Semantic::labelToToken.at(node->getLabel()));
-
-            //Evaluates the subexpression of the operator and assigns the result as the second operand
-            for (const std::shared_ptr<TreeNode>& child : node->getChildren()) {
-                //If another expression with subexpression
-                if (child->getLabel() == "Expression") {
-                    op2 = evaluateExpression(child, scope, line);
-                //Otherwise if a terminal subexpression
-                } else if (Semantic::labelToToken.find(node->getLabel()) != Semantic::labelToToken.end()) {
-                    op2 = evaluateExpression(node, scope, line);
-                }
-            }
-            //If operands are valid for current expression, store value in op1
-            if (myOperator.getOperands().first == op1 && myOperator.getOperands().second == op2) {
-                op1 = operators.at(type).getOutput();
-                op2 = Type::NONE;
-            //Otherwise throw operator error
-            } else {
+            op1 = evaluateExpression(node, scope, line);
+            constant = node->isConstant();
+            value = node->getConstantValue();
+        //Identifies an operator, whose subexpression is the second operand
+        } else if (node->getOperator() != Pattern::TokenType::NONE) {
+            Pattern::TokenType type = node->getOperator();
+            Type op2 = evaluateExpression(node, scope, line);
+
+            //If operands are valid for current expression, store result in op1
+            Type result = Operators::RESULTS[Operators::index(type)][Operators::index(op1)][Operators::index(op2)];
+            if (result == Type::NONE) {
                 generateOperatorError(type, op1, op2, line);
             }
+
+            //Folds operator if its operands are known ('not' only has the second operand)
+            constant = (constant || type == Pattern::TokenType::NOT) && node->isConstant();
+            if (constant) {
+                value = foldOperator(type, value, node->getConstantValue(), line);
+            }
+
+            op1 = result;
         }
     }
 
+    //Records type and any constant value of expression
+    parseTree->setType(op1);
+    if (constant) {
+        parseTree->setConstantValue(value);
+    }
+
     //Returns result of current operation, stored in first operand
     return op1;
 }
 
+/**
+ * Evaluates an integer literal, throwing an error if it does not fit in an int
+ * @param token - of literal
+ * @return value of literal
+ */
+long TypeChecker::evaluateLiteral(const Token &token) {
+    const std::string& digits = token.getValue();
+    long value = 0;
+
+    //Accumulates digits, stopping as soon as the value is out of range
+    for (char digit : digits) {
+        value = value * 10 + (digit - '0');
+
+        if (value > std::numeric_limits<int>::max()) {
+            std::string err = "Error: integer literal " + digits + " on line " + std::to_string(token.getLineNum());
+            err += ", character " + std::to_string(token.getColNum()) + " is out of range of type 'int'";
+            throw TypeException(err);
+        }
+    }
+
+    return value;
+}
+
+/**
+ * Applies an operator to operands known at compile time, throwing an error
+ * if it would divide by zero or overflow an int at runtime
+ * @param type - of operator
+ * @param op1 - value of first operand (unused by 'not')
+ * @param op2 - value of second operand
+ * @param line - of expression for error handling
+ * @return value of result (booleans are 0 or 1)
+ */
+long TypeChecker::foldOperator(Pattern::TokenType type, long op1, long op2, unsigned long line) {
+    long result = 0;
+
+    switch (type) {
+        case Pattern::TokenType::PLUS:
+            result = op1 + op2;
+            break;
+        case Pattern::TokenType::MINUS:
+            result = op1 - op2;
+            break;
+        case Pattern::TokenType::MULTIPLY:
+            result = op1 * op2;
+            break;
+        case Pattern::TokenType::DIVIDE:
+            if (op2 == 0) {
+                throw TypeException("Error: division by zero in constant expression on line " + std::to_string(line));
+            }
+            result = op1 / op2;
+            break;
+        case Pattern::TokenType::AND:
+            return op1 && op2;
+        case Pattern::TokenType::OR:
+            return op1 || op2;
+        case Pattern::TokenType::NOT:
+            return !op2;
+        case Pattern::TokenType::LT:
+            return op1 < op2;
+        case Pattern::TokenType::GT:
+            return op1 > op2;
+        case Pattern::TokenType::LTE:
+            return op1 <= op2;
+        case Pattern::TokenType::GTE:
+            return op1 >= op2;
+        case Pattern::TokenType::EQ:
+            return op1 == op2;
+        default:
+            break;
+    }
+
+    //Arithmetic on ints cannot exceed their range (both operands fit in an int, so this cannot overflow a long)
+    if (result > std::numeric_limits<int>::max() || result < std::numeric_limits<int>::min()) {
+        throw TypeException("Error: integer overflow in constant expression on line " + std::to_string(line));
+    }
+
+    return result;
+}
+
 /**
  * Generate a type error indicating that an expression produced an unexpected type
  * @param expected - expected type of expression
@@ -468,9 +699,8 @@ void TypeChecker::generateTypeError(Type expected, Type result, unsigned long li
             break;
     }
 
-    //Print error message and throw error
-    std::cout << err << std::endl;
-    throw TypeException(nullptr);
+    //Throw error, to be printed by the caller
+    throw TypeException(err);
 }
 
 /**
@@ -486,8 +716,8 @@ void TypeChecker::generateOperatorError(Pattern::TokenType type, Type op1, Type
     std::vector<std::string> opStrings;
 
     //Add expected and actual operands to list
-    opTypes.emplace_back(operators.at(type).getOperands().first);
-    opTypes.emplace_back(operators.at(type).getOperands().second);
+    opTypes.emplace_back(Operators::OPERATORS[Operators::index(type)].getOperands().first);
+    opTypes.emplace_back(Operators::OPERATORS[Operators::index(type)].getOperands().second);
     opTypes.emplace_back(op1);
     opTypes.emplace_back(op2);
 
@@ -520,9 +750,8 @@ void TypeChecker::generateOperatorError(Pattern::TokenType type, Type op1, Type
     err += " of type ";
     err += (type == Pattern::TokenType::NOT) ? "'" + opStrings[3] + "'" : "<" + opStrings[2] + ", " + opStrings[3] + ">";
 
-    //Print and throw error
-    std::cout << err << std::endl;
-    throw TypeException(nullptr);
+    //Throw error, to be printed by the caller
+    throw TypeException(err);
 }
 
 /**
@@ -587,9 +816,8 @@ void TypeChecker::generateParameterError(const std::string& funcID, const std::v
     err += "\nProcedure expects arguments of type " + formalStr;
     err += "\nCannot apply to arguments of type " + actualStr;
 
-    //Print error and throw error
-    std::cout << err << std::endl;
-    throw TypeException(nullptr);
+    //Throw error, to be printed by the caller
+    throw TypeException(err);
 }
 
 
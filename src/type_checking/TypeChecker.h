@@ -11,9 +11,57 @@
  */
 class TypeChecker {
 public:
+    //Constructor
+    explicit TypeChecker(unsigned int jobs = 1);
+
     //Main type checking logic
     void checkTypes(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& global);
+
+    //Type checks a statement without inner blocks during a fused pass with semantic analysis
+    void checkStatement(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& scope);
+
+    //Type checks the condition of a conditional statement during a fused pass with semantic analysis
+    void checkCondition(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<TreeNode>& condition,
+                        const std::shared_ptr<Scope>& scope);
+
+    //Reports the result of a fused pass, exiting if a type error was found
+    void report();
+
+    //Getter for first type error found during a fused pass
+    const std::string &getError() const;
+
+    //Setter for first type error found during a fused pass
+    void setError(const std::string &error);
 private:
+    //First type error found during a fused pass, empty if none
+    std::string firstError;
+
+    //Number of threads used to check the bodies of top-level procedures
+    unsigned int jobs;
+
+    //Signature of a top-level procedure whose body is checked once all top-level statements have been
+    struct ProcedureBody {
+        //Position of the procedure's statement in the global scope, ordering errors as in source
+        unsigned long sequence;
+
+        //Function signature node
+        std::shared_ptr<TreeNode> signature;
+
+        //First type error in the body, empty if none
+        std::string error;
+    };
+
+    //Top-level procedure bodies deferred until the global scope has been checked
+    std::vector<ProcedureBody> bodies;
+
+    //Position of the global statement being checked
+    unsigned long sequence = 0;
+
+    //Validates types of the global scope, checking the bodies of top-level procedures in parallel
+    void validateGlobalScopeTypes(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& global);
+
+    //Prints the heading of the type checking output
+    void printHeader();
 
     //Validates types of a scope in parse tree
     void validateScopeTypes(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& scope);
@@ -34,7 +82,7 @@ private:
     void assignment(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& scope);
 
     //Validates types of a function signature/declaration
-    void functionSig(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& scope);
+    void functionSig(const std::shared_ptr<TreeNode>& parseTree);
 
     //Validates the function call actual parameter types and returns the type of function
     Type functionCall(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& scope);
@@ -48,6 +96,12 @@ private:
     //Recursively evaluates an expression and returns the resulting type
     Type evaluateExpression(const std::shared_ptr<TreeNode>& parseTree, const std::shared_ptr<Scope>& scope, unsigned long line);;
 
+    //Evaluates an integer literal, throwing an error if out of range
+    static long evaluateLiteral(const Token& token);
+
+    //Applies an operator to operands known at compile time, throwing an error on division by zero or overflow
+    static long foldOperator(Pattern::TokenType type, long op1, long op2, unsigned long line);
+
     //Generate a type error indicating that an expression produced an unexpected type
     void generateTypeError(Type expected, Type result, unsigned long lineNum);
 
@@ -57,23 +111,6 @@ private:
     //Generate a parameter error indicating that a function call has been given an invalid number/type of actual parameters
     void generateParameterError(const std::string& funcID, const std::vector<Type>& formal, const std::vector<Type>& actual,
                                 unsigned long line);
-
-    //List of permitted operators, their operands, and resulting types
-    inline static const std::map<Pattern::TokenType, Operator> operators {
-            {Pattern::TokenType::PLUS, Operator({Type::INT, Type::INT}, Type::INT)},
-            {Pattern::TokenType::MINUS, Operator({Type::INT, Type::INT}, Type::INT)},
-            {Pattern::TokenType::MULTIPLY, Operator({Type::INT, Type::INT}, Type::INT)},
-            {Pattern::TokenType::DIVIDE, Operator({Type::INT, Type::INT}, Type::INT)},
-            {Pattern::TokenType::AND, Operator({Type::BOOL, Type::BOOL}, Type::BOOL)},
-            {Pattern::TokenType::OR, Operator({Type::BOOL, Type::BOOL}, Type::BOOL)},
-            {Pattern::TokenType::LT, Operator({Type::INT, Type::INT}, Type::BOOL)},
-            {Pattern::TokenType::GT, Operator({Type::INT, Type::INT}, Type::BOOL)},
-            {Pattern::TokenType::LTE, Operator({Type::INT, Type::INT}, Type::BOOL)},
-            {Pattern::TokenType::GTE, Operator({Type::INT, Type::INT}, Type::BOOL)},
-            {Pattern::TokenType::EQ, Operator({Type::INT, Type::INT}, Type::BOOL)},
-            {Pattern::TokenType::NOT, Operator({Type::NONE, Type::BOOL}, Type::BOOL)},
-
-    };
 };
 
 
@@ -1,21 +1,22 @@
 #pragma once
 
 #include <exception>
+#include <string>
 
 /**
  * Custom error which is thrown if an error
- * occurs during type checking
+ * occurs during type checking, carrying the message to report
  */
 class TypeException : public std::exception {
 private:
-    const char* errMsg;
+    std::string errMsg;
 
 public:
-    explicit TypeException(const char* msg) : errMsg(msg)
+    explicit TypeException(std::string msg) : errMsg(std::move(msg))
     {
     }
 
     virtual const char* what() const throw() {
-        return errMsg;
+        return errMsg.c_str();
     }
 };